@@ -14,7 +14,7 @@ if %errorlevel% neq 0 (
 
 REM Compile the program
 echo Compiling...
-g++ -std=c++17 -Wall -Wextra -O2 -Iinclude -Isrc -o catalog_assignment.exe src/main.cpp
+g++ -std=c++17 -Wall -Wextra -O2 -pthread -Iinclude -Isrc -o catalog_assignment.exe src/main.cpp -lbcrypt
 
 if %errorlevel% equ 0 (
     echo ✅ Compilation successful!
@@ -15,7 +15,7 @@ fi
 
 # Compile the program
 echo "Compiling..."
-g++ -std=c++17 -Wall -Wextra -O2 -Iinclude -Isrc -o catalog_assignment src/main.cpp
+g++ -std=c++17 -Wall -Wextra -O2 -pthread -Iinclude -Isrc -o catalog_assignment src/main.cpp
 
 if [ $? -eq 0 ]; then
     echo "✅ Compilation successful!"
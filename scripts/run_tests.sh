@@ -13,25 +13,160 @@ if [ ! -f "shamirs_secret" ]; then
     fi
 fi
 
+FAILED=0
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Run a solve and check the secret it reports
+expect_secret() {
+    local expected="$1"
+    shift
+    local output
+    output=$("$@" 2>&1)
+    echo "$output"
+    if echo "$output" | grep -q "SECRET: $expected\$"; then
+        echo "✔️  Recovered $expected"
+    else
+        echo "❌ Expected secret $expected from: $*"
+        FAILED=1
+    fi
+}
+
+# Run a solve and check that its report contains a line
+expect_report() {
+    local expected="$1"
+    shift
+    local output
+    output=$("$@" 2>&1)
+    echo "$output"
+    if echo "$output" | grep -qF "$expected"; then
+        echo "✔️  Reported: $expected"
+    else
+        echo "❌ Expected \"$expected\" from: $*"
+        FAILED=1
+    fi
+}
+
+# Run a batch recovery and check every secret it reports, in order
+expect_batch() {
+    local file="$1"
+    shift
+    local output
+    output=$(./shamirs_secret --batch "$file" 2>&1)
+    echo "$output"
+    local i=1 ok=1
+    for expected in "$@"; do
+        if ! echo "$output" | grep -q "Secret $i: $expected\$"; then
+            echo "❌ Expected secret $i of $file to be $expected"
+            FAILED=1
+            ok=0
+        fi
+        i=$((i + 1))
+    done
+    if [ $ok -eq 1 ]; then
+        echo "✔️  Recovered all $# secrets"
+    fi
+}
+
+# Split a secret, solve the shares and check the round trip
+expect_round_trip() {
+    local secret="$1" k="$2" n="$3"
+    shift 3
+    local file="$WORKDIR/split_${k}_${n}.json"
+    if ! ./shamirs_secret --split "$secret" -k "$k" -n "$n" -o "$file"; then
+        echo "❌ Could not split $secret into $n shares"
+        FAILED=1
+        return
+    fi
+    expect_secret "$secret" ./shamirs_secret "$file" "$@"
+}
+
+# Run a solve and check the wrong shares it reports
+expect_wrong_shares() {
+    local expected="$1"
+    shift
+    local output
+    output=$("$@" 2>&1)
+    echo "$output"
+    if echo "$output" | grep -q "WRONG SHARES DETECTED: $expected\$"; then
+        echo "✔️  Flagged $expected"
+    else
+        echo "❌ Expected wrong shares $expected from: $*"
+        FAILED=1
+    fi
+}
+
 echo
 echo "📋 Test 1: Basic functionality"
 echo "------------------------------"
-./shamirs_secret examples/test1.json
+# The original examples have no consensus: every combination gives its
+# own secret, so the report of the tie is checked instead of the pick
+expect_report "NO CONSENSUS: 10 secrets tie" ./shamirs_secret examples/test1.json
 
 echo
 echo "📋 Test 2: Verbose output"
 echo "-------------------------"
-./shamirs_secret examples/test2.json --verbose
+expect_report "NO CONSENSUS: 35 secrets tie" ./shamirs_secret examples/test2.json --verbose
 
 echo
 echo "📋 Test 3: Nuclear scenario (large numbers)"
 echo "-------------------------------------------"
-./shamirs_secret examples/nuclear_scenario.json --time
+expect_report "NO CONSENSUS: 56 secrets tie" ./shamirs_secret examples/nuclear_scenario.json --time
 
 echo
 echo "📋 Test 4: Default input"
 echo "------------------------"
-./shamirs_secret examples/input.json
+expect_report "NO CONSENSUS: 15 secrets tie" ./shamirs_secret examples/input.json
 
 echo
+echo "📋 Test 5: Alternative decoders"
+echo "-------------------------------"
+# Reed-Solomon decoding gives up on them and falls back to enumeration;
+# verification finds no candidate with enough agreeing shares
+expect_report "NO CONSENSUS: 10 secrets tie" ./shamirs_secret examples/test1.json --decoder rs
+expect_report "NO CONSENSUS: 35 secrets tie" ./shamirs_secret examples/test2.json --decoder rs
+expect_report "NO CONSENSUS: 56 secrets tie" ./shamirs_secret examples/nuclear_scenario.json --decoder rs
+expect_report "NO CONSENSUS: 15 secrets tie" ./shamirs_secret examples/input.json --decoder rs
+expect_report "No candidate reached 4 agreeing shares" ./shamirs_secret examples/test1.json --decoder verify
+expect_report "No candidate reached 6 agreeing shares" ./shamirs_secret examples/test2.json --decoder verify
+expect_report "No candidate reached 7 agreeing shares" ./shamirs_secret examples/nuclear_scenario.json --decoder verify
+expect_report "No candidate reached 5 agreeing shares" ./shamirs_secret examples/input.json --decoder verify
+# A file where the answer is unique, so the sampled one is too
+for decoder in enum rs verify "sample --seed 42"; do
+    expect_secret 1234567890123456789 ./shamirs_secret examples/corrupted_shares.json --decoder $decoder
+done
+
+echo
+echo "📋 Test 6: Share at x = 0"
+echo "-------------------------"
+# Every combination holding share 0 reproduces the secret, the wrong
+# share 1 included, so only the others may vouch for shares
+for threads in 1 3; do
+    expect_wrong_shares "Share 1" ./shamirs_secret examples/zero_id_share.json --threads $threads
+done
+
+echo
+echo "📋 Test 7: Batch recovery"
+echo "-------------------------"
+expect_batch examples/batch.json \
+    92528194338513647842342521865086928752 \
+    90448459813435722746811155431019595656 \
+    135034004891187903292782490759172135082 \
+    44045889315371269425022761656577999644
+expect_batch examples/batch_small_prime.json 2
+
+echo
+echo "📋 Test 8: Split and recover"
+echo "----------------------------"
+expect_round_trip 123456789 3 6
+expect_round_trip 123456789 2 130
+expect_round_trip 170141183460469231731687303715884105726 5 9 --threads 2
+# Subproduct-tree evaluation and interpolation (k >= 256); takes a minute
+expect_round_trip 987654321987654321 256 256 --decoder verify
+
+echo
+if [ $FAILED -ne 0 ]; then
+    echo "❌ Some tests failed!"
+    exit 1
+fi
 echo "✅ All tests completed!"
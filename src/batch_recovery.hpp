@@ -0,0 +1,120 @@
+#ifndef BATCH_RECOVERY_HPP
+#define BATCH_RECOVERY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bigint.hpp"
+#include "bigint_arena.hpp"
+#include "prime_field.hpp"
+#include "lagrange_cache.hpp"
+#include "work_stealing.hpp"
+
+// Recovers many secrets that were all split to the same share ids. The
+// Lagrange weights are computed once for the x-set, after which every
+// secret is one row of a matrix-vector product
+//     secrets = Y * w     (Y: secrets x shares, w: L_i(0) per share)
+// Rows are processed in blocks so each weight is reused across a block
+// while it is hot, products are summed unreduced and reduced once per
+// row, and blocks are spread over worker threads.
+class BatchRecovery {
+private:
+    PrimeField field;
+    std::vector<long long> shareIds;
+    std::vector<BigInt> columnWeights;  // columnWeights[j] belongs to shareIds[j]
+    int threads;
+    
+    // Secrets of rows [begin, end) into out; temporaries stay in the arena
+    void recoverBlock(const std::vector<std::vector<BigInt>>& ys, size_t begin, size_t end,
+                      std::vector<BigInt>& out, BigIntArena& arena) const {
+        {
+            BigIntArena::ResetScope scope(arena);
+            const BigInt& p = field.modulus();
+            std::vector<BigInt> sums(end - begin, BigInt(0));
+            
+            for (size_t j = 0; j < columnWeights.size(); j++) {
+                const BigInt& weight = columnWeights[j];
+                for (size_t row = begin; row < end; row++) {
+                    const BigInt& y = ys[row][j];
+                    if (y.isNegative() || !(y < p)) {
+                        sums[row - begin] = sums[row - begin] + weight * field.reduce(y);
+                    } else {
+                        sums[row - begin] = sums[row - begin] + weight * y;
+                    }
+                }
+            }
+            
+            // out was allocated outside the arena and keeps its own resource
+            for (size_t row = begin; row < end; row++) {
+                out[row] = sums[row - begin] % p;
+            }
+        }
+    }
+
+public:
+    // Rows handed to one worker at a time
+    static constexpr size_t BlockRows = 64;
+    
+    // ids are the share x-coordinates in the column order of every row
+    // passed to recover(); threads = 0 uses every core
+    BatchRecovery(const std::vector<long long>& ids, const BigInt& modulus, int threadCount = 1,
+                  LagrangeWeightCache& cache = LagrangeWeightCache::shared())
+        : field(modulus), shareIds(ids), threads(resolveThreadCount(threadCount)) {
+        if (ids.empty()) {
+            throw std::runtime_error("Batch recovery needs at least one share id");
+        }
+        
+        // The cache orders weights by ascending x; map them back to columns
+        BigIntHeapScope heap;
+        std::shared_ptr<const LagrangeWeights> weights = cache.weights(ids, modulus);
+        columnWeights.reserve(ids.size());
+        for (long long id : ids) {
+            size_t pos = std::lower_bound(weights->xs.begin(), weights->xs.end(), id) - weights->xs.begin();
+            columnWeights.push_back(weights->weights[pos]);
+        }
+    }
+    
+    const std::vector<long long>& ids() const {
+        return shareIds;
+    }
+    
+    // f(0) for every row of ys; each row holds one y-value per share id
+    std::vector<BigInt> recover(const std::vector<std::vector<BigInt>>& ys) const {
+        for (size_t row = 0; row < ys.size(); row++) {
+            if (ys[row].size() != shareIds.size()) {
+                throw std::runtime_error("Secret " + std::to_string(row + 1) + " has " + std::to_string(ys[row].size()) +
+                                         " shares, expected " + std::to_string(shareIds.size()));
+            }
+        }
+        
+        std::vector<BigInt> secrets(ys.size());
+        uint64_t blocks = (ys.size() + BlockRows - 1) / BlockRows;
+        int workers = static_cast<int>(std::min<uint64_t>(threads, std::max<uint64_t>(1, blocks)));
+        
+        std::vector<std::unique_ptr<BigIntArena>> arenas;
+        for (int i = 0; i < workers; i++) {
+            arenas.push_back(std::make_unique<BigIntArena>());
+        }
+        
+        auto body = [&](uint64_t first, uint64_t last, int worker) {
+            for (uint64_t block = first; block < last; block++) {
+                size_t begin = block * BlockRows;
+                size_t end = std::min(ys.size(), begin + BlockRows);
+                recoverBlock(ys, begin, end, secrets, *arenas[worker]);
+            }
+        };
+        
+        if (workers <= 1) {
+            body(0, blocks, 0);
+        } else {
+            WorkStealingRanges ranges(blocks, workers, 1);
+            ranges.run(body);
+        }
+        return secrets;
+    }
+};
+
+#endif
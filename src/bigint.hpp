@@ -6,12 +6,26 @@
 #include <iostream>
 #include <algorithm>
 #include <stdexcept>
+#include <memory_resource>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include "bigint_stats.hpp"
+
+enum class ByteOrder { BigEndian, LittleEndian };
 
 class BigInt {
 private:
-    std::vector<int> digits;
+    std::pmr::vector<int> digits;
     bool negative;
     
+    // Per-thread resource new BigInts allocate from (nullptr = default heap)
+    static std::pmr::memory_resource*& activeResource() {
+        thread_local std::pmr::memory_resource* resource = nullptr;
+        return resource;
+    }
+    
     void removeLeadingZeros() {
         while (digits.size() > 1 && digits.back() == 0) {
             digits.pop_back();
@@ -21,12 +35,203 @@ private:
         }
     }
     
+    static uint64_t mix64(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+    
+    // Packs 16 decimal limbs per 64-bit word (4 bits each) and folds the
+    // words into a seeded multiply-xorshift chain
+    uint64_t fingerprintLane(uint64_t seed) const {
+        uint64_t h = seed ^ (digits.size() * 0x9e3779b97f4a7c15ULL) ^ (negative ? 0xff51afd7ed558ccdULL : 0);
+        size_t i = 0;
+        while (i < digits.size()) {
+            uint64_t word = 0;
+            for (int shift = 0; shift < 64 && i < digits.size(); shift += 4, i++) {
+                word |= static_cast<uint64_t>(digits[i]) << shift;
+            }
+            h = mix64(h ^ word) * 0x9fb21c651e98df25ULL;
+        }
+        return mix64(h);
+    }
+    
+    // digits = digits * factor + addend, for small non-negative factor/addend
+    void mulSmallAdd(int factor, int addend) {
+        int carry = addend;
+        for (size_t i = 0; i < digits.size(); i++) {
+            int value = digits[i] * factor + carry;
+            digits[i] = value % 10;
+            carry = value / 10;
+        }
+        while (carry > 0) {
+            digits.push_back(carry % 10);
+            carry /= 10;
+        }
+        removeLeadingZeros();
+    }
+    
+    // digits = digits / divisor, returning the remainder of the magnitude
+    int divSmall(int divisor) {
+        int remainder = 0;
+        for (size_t i = digits.size(); i-- > 0; ) {
+            int value = remainder * 10 + digits[i];
+            digits[i] = value / divisor;
+            remainder = value % divisor;
+        }
+        removeLeadingZeros();
+        return remainder;
+    }
+    
+    bool isZero() const {
+        return digits.size() == 1 && digits[0] == 0;
+    }
+    
+    bool isEven() const {
+        return digits[0] % 2 == 0;
+    }
+    
+    static int compareMagnitude(const BigInt& a, const BigInt& b) {
+        if (a.digits.size() != b.digits.size()) {
+            return a.digits.size() < b.digits.size() ? -1 : 1;
+        }
+        for (size_t i = a.digits.size(); i-- > 0; ) {
+            if (a.digits[i] != b.digits[i]) {
+                return a.digits[i] < b.digits[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+    
+    // |this| -= |smaller| in place; requires |this| >= |smaller|
+    void subtractMagnitude(const BigInt& smaller) {
+        int borrow = 0;
+        for (size_t i = 0; i < digits.size(); i++) {
+            int sub = digits[i] - borrow - (i < smaller.digits.size() ? smaller.digits[i] : 0);
+            borrow = sub < 0;
+            digits[i] = borrow ? sub + 10 : sub;
+            if (!borrow && i >= smaller.digits.size()) break;
+        }
+        removeLeadingZeros();
+    }
+    
+    // Top `count` limbs of `value`, taken at the positions of the top
+    // limbs of a number `width` limbs long (shorter values read as zero)
+    static long long leadingLimbs(const BigInt& value, size_t width, size_t count) {
+        long long result = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t position = width - 1 - i;
+            result = result * 10 + (position < value.digits.size() ? value.digits[position] : 0);
+        }
+        return result;
+    }
+    
+    // Stein's binary GCD on magnitudes: only halving and subtraction, both
+    // in place, O(n^2) limb operations overall
+    static BigInt binaryGcd(BigInt u, BigInt v) {
+        u.negative = v.negative = false;
+        if (u.isZero()) return v;
+        if (v.isZero()) return u;
+        
+        int shift = 0;
+        while (u.isEven() && v.isEven()) {
+            u.divSmall(2);
+            v.divSmall(2);
+            shift++;
+        }
+        while (u.isEven()) u.divSmall(2);
+        
+        while (!v.isZero()) {
+            while (v.isEven()) v.divSmall(2);
+            if (compareMagnitude(u, v) > 0) std::swap(u, v);
+            v.subtractMagnitude(u);
+        }
+        
+        for (int i = 0; i < shift; i++) u.mulSmallAdd(2, 0);
+        return u;
+    }
+    
+    // Lehmer's GCD: runs Euclid on the leading 18 limbs in machine words and
+    // applies the accumulated cofactors to the full numbers in one step, so
+    // most multiprecision divisions disappear. Hands off to binaryGcd once
+    // the operands are small.
+    static BigInt lehmerGcd(BigInt u, BigInt v) {
+        u.negative = v.negative = false;
+        if (compareMagnitude(u, v) < 0) std::swap(u, v);
+        
+        const size_t lead = 18;
+        while (!v.isZero() && u.digits.size() >= LehmerThreshold) {
+            long long uHat = leadingLimbs(u, u.digits.size(), lead);
+            long long vHat = leadingLimbs(v, u.digits.size(), lead);
+            long long A = 1, B = 0, C = 0, D = 1;
+            
+            // Knuth, TAOCP vol. 2, Algorithm 4.5.2L
+            while (vHat + C != 0 && vHat + D != 0) {
+                long long q = (uHat + A) / (vHat + C);
+                if (q != (uHat + B) / (vHat + D)) break;
+                long long t = A - q * C; A = C; C = t;
+                t = B - q * D; B = D; D = t;
+                t = uHat - q * vHat; uHat = vHat; vHat = t;
+            }
+            
+            if (B == 0) {
+                BigInt t = u % v;
+                u = std::move(v);
+                v = std::move(t);
+            } else {
+                BigInt nextU = BigInt(A) * u + BigInt(B) * v;
+                BigInt nextV = BigInt(C) * u + BigInt(D) * v;
+                u = std::move(nextU);
+                v = std::move(nextV);
+            }
+        }
+        return binaryGcd(u, v);
+    }
+    
 public:
-    BigInt() : negative(false) {
+    // Memory resource used by BigInts constructed on this thread
+    static std::pmr::memory_resource* memoryResource() {
+        std::pmr::memory_resource* resource = activeResource();
+#ifdef BIGINT_STATS
+        return resource ? resource : BigIntStats::heapResource();
+#else
+        return resource ? resource : std::pmr::get_default_resource();
+#endif
+    }
+    
+    // Redirect allocations on this thread; returns the previous resource
+    static std::pmr::memory_resource* setMemoryResource(std::pmr::memory_resource* resource) {
+        std::pmr::memory_resource* previous = activeResource();
+        activeResource() = resource;
+        return previous;
+    }
+    
+    BigInt() : digits(memoryResource()), negative(false) {
         digits.push_back(0);
     }
     
-    BigInt(const std::string& str) : negative(false) {
+    // Copies and moves land in the constructing thread's current resource,
+    // not the source's. Assignment keeps the destination's resource (pmr
+    // does not propagate), so a result computed inside an arena Scope
+    // survives the arena's reset() only when it is assigned into a BigInt
+    // constructed outside the Scope. Any BigInt constructed inside the
+    // Scope is invalid after the reset.
+    BigInt(const BigInt& other) : digits(other.digits, memoryResource()), negative(other.negative) {}
+    
+    // Steals the digits when both resources compare equal; otherwise the
+    // vector copies them into the current resource, which allocates. The
+    // move is noexcept so that vector<BigInt> moves its elements when it
+    // grows instead of copying them; if that copy runs out of memory, the
+    // exception cannot propagate and std::terminate is called.
+    BigInt(BigInt&& other) noexcept : digits(std::move(other.digits), memoryResource()), negative(other.negative) {}
+    
+    BigInt& operator=(const BigInt& other) = default;
+    BigInt& operator=(BigInt&& other) = default;
+    
+    BigInt(const std::string& str) : digits(memoryResource()), negative(false) {
         if (str.empty()) {
             digits.push_back(0);
             return;
@@ -45,7 +250,7 @@ public:
             return;
         }
         
-        for (int i = str.length() - 1; i >= start; i--) {
+        for (size_t i = str.length(); i-- > start; ) {
             if (str[i] < '0' || str[i] > '9') {
                 throw std::runtime_error("Invalid character in number: " + std::string(1, str[i]));
             }
@@ -55,7 +260,7 @@ public:
         removeLeadingZeros();
     }
     
-    BigInt(long long num) {
+    BigInt(long long num) : digits(memoryResource()) {
         negative = num < 0;
         if (negative) num = -num;
         
@@ -80,7 +285,123 @@ public:
         return result;
     }
     
+    // Read-only view of the little-endian base-10 limbs backing the value
+    struct LimbView {
+        const int* data;
+        size_t size;
+        
+        const int* begin() const { return data; }
+        const int* end() const { return data + size; }
+        int operator[](size_t i) const { return data[i]; }
+    };
+    
+    static constexpr int LimbBase = 10;
+    
+    LimbView limbs() const {
+        return {digits.data(), digits.size()};
+    }
+    
+    bool isNegative() const {
+        return negative;
+    }
+    
+    // Value as a machine integer; throws if it does not fit
+    long long toLongLong() const {
+        const long long limit = std::numeric_limits<long long>::max();
+        long long result = 0;
+        for (size_t i = digits.size(); i-- > 0; ) {
+            if (result > (limit - digits[i]) / 10) {
+                throw std::runtime_error("BigInt does not fit in 64 bits: " + toString());
+            }
+            result = result * 10 + digits[i];
+        }
+        return negative ? -result : result;
+    }
+    
+    // Build a value directly from little-endian base-10 limbs
+    static BigInt fromLimbs(const int* limbs, size_t count, bool negativeValue = false) {
+        BigInt result;
+        if (count == 0) return result;
+        
+        result.digits.assign(limbs, limbs + count);
+        for (int limb : result.digits) {
+            if (limb < 0 || limb >= LimbBase) {
+                throw std::runtime_error("Invalid limb value: " + std::to_string(limb));
+            }
+        }
+        result.negative = negativeValue;
+        result.removeLeadingZeros();
+        return result;
+    }
+    
+    // Import an unsigned magnitude from raw bytes
+    static BigInt fromBytes(const uint8_t* bytes, size_t length, ByteOrder order = ByteOrder::BigEndian) {
+        BigInt result;
+        for (size_t i = 0; i < length; i++) {
+            uint8_t byte = order == ByteOrder::BigEndian ? bytes[i] : bytes[length - 1 - i];
+            result.mulSmallAdd(256, byte);
+        }
+        return result;
+    }
+    
+    static BigInt fromBytes(const std::vector<uint8_t>& bytes, ByteOrder order = ByteOrder::BigEndian) {
+        return fromBytes(bytes.data(), bytes.size(), order);
+    }
+    
+    // Export the magnitude as raw bytes. A non-zero width left-pads (in the
+    // chosen byte order) to exactly that many bytes.
+    std::vector<uint8_t> toBytes(ByteOrder order = ByteOrder::BigEndian, size_t width = 0) const {
+        if (negative) {
+            throw std::runtime_error("Cannot export a negative BigInt as bytes");
+        }
+        
+        std::vector<uint8_t> bytes; // little-endian while building
+        BigInt remaining = *this;
+        while (!(remaining.digits.size() == 1 && remaining.digits[0] == 0)) {
+            bytes.push_back(static_cast<uint8_t>(remaining.divSmall(256)));
+        }
+        
+        if (width != 0) {
+            if (bytes.size() > width) {
+                throw std::runtime_error("BigInt does not fit in " + std::to_string(width) + " bytes");
+            }
+            bytes.resize(width, 0);
+        } else if (bytes.empty()) {
+            bytes.push_back(0);
+        }
+        
+        if (order == ByteOrder::BigEndian) {
+            std::reverse(bytes.begin(), bytes.end());
+        }
+        return bytes;
+    }
+    
+    struct Fingerprint128 {
+        uint64_t high;
+        uint64_t low;
+        
+        bool operator==(const Fingerprint128& other) const {
+            return high == other.high && low == other.low;
+        }
+        bool operator!=(const Fingerprint128& other) const {
+            return !(*this == other);
+        }
+    };
+    
+    // 64-bit fingerprint of the value, computed straight from the limbs.
+    // Equal values always agree; this is a hash, not a cryptographic digest.
+    uint64_t fingerprint64() const {
+        return fingerprintLane(0x9e3779b97f4a7c15ULL);
+    }
+    
+    // Two independently seeded lanes, for tallies that want to treat
+    // fingerprint equality as value equality
+    Fingerprint128 fingerprint128() const {
+        return {fingerprintLane(0xc2b2ae3d27d4eb4fULL), fingerprintLane(0x165667b19e3779f9ULL)};
+    }
+    
     bool operator<(const BigInt& other) const {
+        BIGINT_STATS_OP(Compare, *this, other);
         if (negative != other.negative) {
             return negative;
         }
@@ -102,8 +423,11 @@ public:
         return other < *this;
     }
     
+    // Values are kept normalized (no leading zeros, no negative zero), so
+    // equality is a plain limb comparison
     bool operator==(const BigInt& other) const {
-        return !(*this < other) && !(other < *this);
+        BIGINT_STATS_OP(Compare, *this, other);
+        return negative == other.negative && digits == other.digits;
     }
     
     bool operator!=(const BigInt& other) const {
@@ -111,6 +435,7 @@ public:
     }
     
     BigInt operator+(const BigInt& other) const {
+        BIGINT_STATS_OP(Add, *this, other);
         if (negative != other.negative) {
             if (negative) {
                 BigInt temp = *this;
@@ -144,6 +469,7 @@ public:
     }
     
     BigInt operator-(const BigInt& other) const {
+        BIGINT_STATS_OP(Subtract, *this, other);
         if (negative != other.negative) {
             BigInt result = *this;
             BigInt temp = other;
@@ -186,6 +512,7 @@ public:
     }
     
     BigInt operator*(const BigInt& other) const {
+        BIGINT_STATS_OP(Multiply, *this, other);
         BigInt result;
         result.digits.assign(digits.size() + other.digits.size(), 0);
         result.negative = negative != other.negative;
@@ -203,6 +530,7 @@ public:
     }
     
     BigInt operator/(const BigInt& other) const {
+        BIGINT_STATS_OP(Divide, *this, other);
         if (other == BigInt("0")) {
             throw std::runtime_error("Division by zero");
         }
@@ -239,9 +567,38 @@ public:
     }
     
     BigInt operator%(const BigInt& other) const {
+        BIGINT_STATS_OP(Modulo, *this, other);
         BigInt quotient = *this / other;
         return *this - (quotient * other);
     }
+    
+    // Operands with at least this many limbs go through Lehmer's algorithm
+    static constexpr size_t LehmerThreshold = 40;
+    
+    // Greatest common divisor of the magnitudes (gcd(0, 0) = 0)
+    static BigInt gcd(const BigInt& a, const BigInt& b) {
+        if (std::max(a.digits.size(), b.digits.size()) >= LehmerThreshold) {
+            return lehmerGcd(a, b);
+        }
+        return binaryGcd(a, b);
+    }
+    
+    // Least common multiple of the magnitudes (lcm(x, 0) = 0)
+    static BigInt lcm(const BigInt& a, const BigInt& b) {
+        if (a.isZero() || b.isZero()) return BigInt();
+        BigInt result = (a / gcd(a, b)) * b;
+        result.negative = false;
+        return result;
+    }
+};
+
+namespace std {
+template <>
+struct hash<BigInt> {
+    size_t operator()(const BigInt& value) const {
+        return static_cast<size_t>(value.fingerprint64());
+    }
 };
+}
 
 #endif
@@ -0,0 +1,105 @@
+#ifndef BIGINT_ARENA_HPP
+#define BIGINT_ARENA_HPP
+
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+#include "bigint.hpp"
+
+// Arena for the short-lived BigInt temporaries of a solve.
+//
+// A pool resource recycles freed digit buffers, and it is backed by a
+// monotonic buffer that owns a preallocated block, so steady-state
+// arithmetic never reaches malloc/free. reset() drops everything at once
+// and rewinds to the preallocated block.
+class BigIntArena {
+private:
+    std::vector<std::byte> storage;
+    std::pmr::monotonic_buffer_resource buffer;
+    std::pmr::unsynchronized_pool_resource pool;
+#ifdef BIGINT_STATS
+    BigIntStats::CountingResource counting{&pool, true};
+#endif
+    
+public:
+    explicit BigIntArena(size_t initialBytes = 256 * 1024)
+        : storage(initialBytes),
+          buffer(storage.data(), storage.size()),
+          pool(&buffer) {}
+    
+    BigIntArena(const BigIntArena&) = delete;
+    BigIntArena& operator=(const BigIntArena&) = delete;
+    
+    std::pmr::memory_resource* resource() {
+#ifdef BIGINT_STATS
+        return &counting;
+#else
+        return &pool;
+#endif
+    }
+    
+    // Release every allocation made from this arena. Any BigInt still
+    // holding arena memory must already be gone.
+    void reset() {
+        pool.release();
+        buffer.release();
+    }
+    
+    // Routes BigInt allocations on the current thread into the arena for
+    // the lifetime of the scope. Results that must survive a reset() should
+    // be assigned into a BigInt declared outside the scope.
+    class Scope {
+    private:
+        std::pmr::memory_resource* previous;
+        
+    public:
+        explicit Scope(BigIntArena& arena)
+            : previous(BigInt::setMemoryResource(arena.resource())) {}
+        
+        ~Scope() {
+            BigInt::setMemoryResource(previous);
+        }
+        
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+    
+    // A Scope that also calls reset() when it ends, including by an
+    // exception, so a failed computation cannot leave its temporaries in
+    // the arena. Every BigInt allocated inside must be gone by then.
+    class ResetScope {
+    private:
+        BigIntArena& arena;
+        Scope scope;
+        
+    public:
+        explicit ResetScope(BigIntArena& target) : arena(target), scope(target) {}
+        
+        ~ResetScope() {
+            arena.reset();
+        }
+        
+        ResetScope(const ResetScope&) = delete;
+        ResetScope& operator=(const ResetScope&) = delete;
+    };
+};
+
+// Routes BigInt allocations on the current thread back to the default heap
+// for the lifetime of the scope. Use it for values that must outlive any
+// arena active further up the stack, such as cached results.
+class BigIntHeapScope {
+private:
+    std::pmr::memory_resource* previous;
+    
+public:
+    BigIntHeapScope() : previous(BigInt::setMemoryResource(nullptr)) {}
+    
+    ~BigIntHeapScope() {
+        BigInt::setMemoryResource(previous);
+    }
+    
+    BigIntHeapScope(const BigIntHeapScope&) = delete;
+    BigIntHeapScope& operator=(const BigIntHeapScope&) = delete;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef BIGINT_STATS_HPP
+#define BIGINT_STATS_HPP
+
+// Opt-in instrumentation for BigInt. Compile with -DBIGINT_STATS to count
+// operator calls, time them, bucket operand sizes and track allocations.
+// Without the flag every hook below expands to nothing.
+
+#ifdef BIGINT_STATS
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+
+namespace BigIntStats {
+
+enum Op { Add, Subtract, Multiply, Divide, Modulo, Compare, OpCount };
+
+// Operand sizes (in digits) are bucketed by powers of two: <=8, <=16, ... >512
+constexpr int BucketCount = 8;
+
+inline const char* opName(int op) {
+    static const char* names[OpCount] = {"add", "subtract", "multiply", "divide", "modulo", "compare"};
+    return names[op];
+}
+
+inline int sizeBucket(size_t digits) {
+    int bucket = 0;
+    size_t limit = 8;
+    while (bucket < BucketCount - 1 && digits > limit) {
+        limit *= 2;
+        bucket++;
+    }
+    return bucket;
+}
+
+struct Counters {
+    std::atomic<uint64_t> calls[OpCount] = {};
+    std::atomic<uint64_t> totalNanos[OpCount] = {};
+    std::atomic<uint64_t> selfNanos[OpCount] = {};
+    std::atomic<uint64_t> sizes[OpCount][BucketCount] = {};
+    std::atomic<uint64_t> heapAllocations{0};
+    std::atomic<uint64_t> heapBytes{0};
+    std::atomic<uint64_t> arenaAllocations{0};
+    std::atomic<uint64_t> arenaBytes{0};
+};
+
+inline Counters& counters() {
+    static Counters instance;
+    return instance;
+}
+
+// Times one operator call. Nested calls (e.g. the subtractions inside a
+// division) are charged to their own operator and subtracted from the
+// caller's self time, so self times add up to total arithmetic time.
+class OpTimer {
+private:
+    int op;
+    OpTimer* parent;
+    uint64_t childNanos = 0;
+    std::chrono::steady_clock::time_point start;
+    
+    static OpTimer*& current() {
+        thread_local OpTimer* active = nullptr;
+        return active;
+    }
+    
+public:
+    OpTimer(int operation, size_t leftDigits, size_t rightDigits)
+        : op(operation), parent(current()) {
+        Counters& c = counters();
+        c.calls[op].fetch_add(1, std::memory_order_relaxed);
+        size_t digits = leftDigits > rightDigits ? leftDigits : rightDigits;
+        c.sizes[op][sizeBucket(digits)].fetch_add(1, std::memory_order_relaxed);
+        current() = this;
+        start = std::chrono::steady_clock::now();
+    }
+    
+    ~OpTimer() {
+        uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        Counters& c = counters();
+        c.totalNanos[op].fetch_add(elapsed, std::memory_order_relaxed);
+        c.selfNanos[op].fetch_add(elapsed > childNanos ? elapsed - childNanos : 0, std::memory_order_relaxed);
+        if (parent) parent->childNanos += elapsed;
+        current() = parent;
+    }
+    
+    OpTimer(const OpTimer&) = delete;
+    OpTimer& operator=(const OpTimer&) = delete;
+};
+
+// Forwards to an upstream resource and records what BigInt asked for
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    bool arena;
+    
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        Counters& c = counters();
+        (arena ? c.arenaAllocations : c.heapAllocations).fetch_add(1, std::memory_order_relaxed);
+        (arena ? c.arenaBytes : c.heapBytes).fetch_add(bytes, std::memory_order_relaxed);
+        return upstream->allocate(bytes, alignment);
+    }
+    
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        upstream->deallocate(p, bytes, alignment);
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+    
+public:
+    CountingResource(std::pmr::memory_resource* upstreamResource, bool arenaBacked)
+        : upstream(upstreamResource), arena(arenaBacked) {}
+};
+
+inline std::pmr::memory_resource* heapResource() {
+    static CountingResource heap(std::pmr::new_delete_resource(), false);
+    return &heap;
+}
+
+inline void reset() {
+    Counters& c = counters();
+    for (int op = 0; op < OpCount; op++) {
+        c.calls[op] = 0;
+        c.totalNanos[op] = 0;
+        c.selfNanos[op] = 0;
+        for (int b = 0; b < BucketCount; b++) c.sizes[op][b] = 0;
+    }
+    c.heapAllocations = 0;
+    c.heapBytes = 0;
+    c.arenaAllocations = 0;
+    c.arenaBytes = 0;
+}
+
+inline void report(std::ostream& out) {
+    Counters& c = counters();
+    uint64_t arithmeticNanos = 0;
+    for (int op = 0; op < OpCount; op++) arithmeticNanos += c.selfNanos[op];
+    
+    out << "📊 BigInt statistics" << std::endl;
+    out << "   " << std::left << std::setw(10) << "operator" << std::right
+        << std::setw(14) << "calls" << std::setw(12) << "total ms"
+        << std::setw(12) << "self ms" << std::setw(8) << "self %" << std::endl;
+    for (int op = 0; op < OpCount; op++) {
+        double selfShare = arithmeticNanos ? 100.0 * c.selfNanos[op] / arithmeticNanos : 0.0;
+        out << "   " << std::left << std::setw(10) << opName(op) << std::right
+            << std::setw(14) << c.calls[op].load()
+            << std::setw(12) << std::fixed << std::setprecision(2) << c.totalNanos[op] / 1e6
+            << std::setw(12) << c.selfNanos[op] / 1e6
+            << std::setw(7) << std::setprecision(1) << selfShare << "%" << std::endl;
+    }
+    out << std::defaultfloat;
+    
+    out << "   Operand sizes (digits, larger operand):" << std::endl;
+    out << "   " << std::left << std::setw(10) << "operator" << std::right;
+    for (int b = 0; b < BucketCount; b++) {
+        std::string label = b == BucketCount - 1 ? ">" + std::to_string(8 << (b - 1))
+                                                 : "<=" + std::to_string(8 << b);
+        out << std::setw(11) << label;
+    }
+    out << std::endl;
+    for (int op = 0; op < OpCount; op++) {
+        out << "   " << std::left << std::setw(10) << opName(op) << std::right;
+        for (int b = 0; b < BucketCount; b++) out << std::setw(11) << c.sizes[op][b].load();
+        out << std::endl;
+    }
+    
+    out << "   Allocations: heap " << c.heapAllocations.load() << " (" << c.heapBytes.load()
+        << " bytes), arena " << c.arenaAllocations.load() << " (" << c.arenaBytes.load()
+        << " bytes)" << std::endl;
+}
+
+} // namespace BigIntStats
+
+#define BIGINT_STATS_OP(op, lhs, rhs) \
+    BigIntStats::OpTimer bigintStatsTimer(BigIntStats::op, (lhs).digits.size(), (rhs).digits.size())
+
+#else
+
+#define BIGINT_STATS_OP(op, lhs, rhs) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef BIGINT_TABLE_HPP
+#define BIGINT_TABLE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include "bigint.hpp"
+
+// Flat hash map from BigInt to V. Entries live densely in insertion order
+// and an open-addressed index (linear probing, load factor at most 1/2)
+// maps fingerprints to entry positions. Lookups compare the stored 64-bit
+// fingerprint before the limbs, entry positions never change, and growing
+// only rebuilds the index, so no key is hashed twice.
+template<typename V>
+class BigIntTable {
+public:
+    struct Entry {
+        BigInt key;
+        V value;
+        uint64_t hash;
+    };
+
+private:
+    static constexpr uint32_t Empty = UINT32_MAX;
+    
+    std::vector<Entry> items;
+    std::vector<uint32_t> index;
+    size_t mask;
+    
+    // Index slot holding key, or the empty slot where it belongs
+    size_t probe(const BigInt& key, uint64_t hash) const {
+        size_t slot = static_cast<size_t>(hash) & mask;
+        while (index[slot] != Empty) {
+            const Entry& entry = items[index[slot]];
+            if (entry.hash == hash && entry.key == key) break;
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+    
+    void grow() {
+        std::vector<uint32_t> larger(index.size() * 2, Empty);
+        mask = larger.size() - 1;
+        for (size_t i = 0; i < items.size(); i++) {
+            size_t slot = static_cast<size_t>(items[i].hash) & mask;
+            while (larger[slot] != Empty) slot = (slot + 1) & mask;
+            larger[slot] = static_cast<uint32_t>(i);
+        }
+        index.swap(larger);
+    }
+    
+    template<typename Key>
+    size_t emplace(Key&& key, uint64_t hash) {
+        size_t slot = probe(key, hash);
+        if (index[slot] != Empty) return index[slot];
+        
+        index[slot] = static_cast<uint32_t>(items.size());
+        items.push_back(Entry{std::forward<Key>(key), V(), hash});
+        if (items.size() * 2 > index.size()) grow();
+        return items.size() - 1;
+    }
+
+public:
+    BigIntTable() : index(16, Empty), mask(15) {}
+    
+    // Position in entries() of key, adding it with a default value if absent.
+    // The hash must be key.fingerprint64().
+    size_t locate(const BigInt& key, uint64_t hash) {
+        return emplace(key, hash);
+    }
+    
+    // Same, moving key in only when it is inserted
+    size_t locate(BigInt&& key, uint64_t hash) {
+        return emplace(std::move(key), hash);
+    }
+    
+    V& operator[](const BigInt& key) {
+        return items[locate(key, key.fingerprint64())].value;
+    }
+    
+    std::vector<Entry>& entries() {
+        return items;
+    }
+    
+    const std::vector<Entry>& entries() const {
+        return items;
+    }
+    
+    size_t size() const {
+        return items.size();
+    }
+    
+    bool empty() const {
+        return items.empty();
+    }
+    
+    void clear() {
+        items.clear();
+        index.assign(16, Empty);
+        mask = 15;
+    }
+};
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef COMBINATIONS_HPP
+#define COMBINATIONS_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+// Pascal's triangle up to n, saturating at UINT64_MAX instead of overflowing
+class BinomialTable {
+private:
+    int rows;
+    std::vector<uint64_t> table;
+
+public:
+    explicit BinomialTable(int n) : rows(n + 1), table(static_cast<size_t>(n + 1) * (n + 1), 0) {
+        for (int i = 0; i <= n; i++) {
+            table[static_cast<size_t>(i) * rows] = 1;
+            for (int j = 1; j <= i; j++) {
+                uint64_t a = at(i - 1, j - 1);
+                uint64_t b = at(i - 1, j);
+                table[static_cast<size_t>(i) * rows + j] =
+                    a > std::numeric_limits<uint64_t>::max() - b ? std::numeric_limits<uint64_t>::max() : a + b;
+            }
+        }
+    }
+    
+    // C(n, k), or 0 when k is out of range
+    uint64_t at(int n, int k) const {
+        if (n < 0 || k < 0 || k > n || n >= rows) return 0;
+        return table[static_cast<size_t>(n) * rows + k];
+    }
+};
+
+// Number of k-subsets of an n-set; throws if it does not fit in 64 bits
+inline uint64_t binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    if (k > n - k) k = n - k;
+    uint64_t result = 1;
+    for (int i = 1; i <= k; i++) {
+        // result * (n - k + i) is divisible by i; cancel the common factors
+        // first so the product only overflows when the answer does
+        uint64_t factor = n - k + i;
+        uint64_t divisor = i;
+        uint64_t g = std::gcd(result, divisor);
+        result /= g;
+        divisor /= g;
+        factor /= divisor;
+        if (result > std::numeric_limits<uint64_t>::max() / factor) {
+            throw std::runtime_error("C(" + std::to_string(n) + ", " + std::to_string(k) + ") does not fit in 64 bits");
+        }
+        result *= factor;
+    }
+    return result;
+}
+
+// Lazily enumerates the k-subsets of {0, ..., n-1} in lexicographic order.
+// The current subset is a single index array updated in place, so nothing
+// is allocated per subset. Subsets are numbered by their lexicographic rank
+// (the combinadic), and a generator can start at any rank, which lets a
+// caller walk an arbitrary slice of the combination space.
+class CombinationGenerator {
+private:
+    int n, k;
+    std::vector<int> indices;
+    bool exhausted;
+
+public:
+    CombinationGenerator(int n, int k, uint64_t startRank = 0) : n(n), k(k), exhausted(false) {
+        if (k < 0 || k > n) {
+            throw std::runtime_error("Invalid combination size " + std::to_string(k) + " of " + std::to_string(n));
+        }
+        if (startRank >= binomial(n, k)) {
+            exhausted = true;
+            indices.assign(k, 0);
+        } else {
+            indices = unrank(startRank, n, k);
+        }
+    }
+    
+    bool done() const {
+        return exhausted;
+    }
+    
+    const std::vector<int>& current() const {
+        return indices;
+    }
+    
+    // Advance to the next subset; returns false once the last one is passed
+    bool next() {
+        if (exhausted) return false;
+        
+        int i = k - 1;
+        while (i >= 0 && indices[i] == n - k + i) i--;
+        if (i < 0) {
+            exhausted = true;
+            return false;
+        }
+        
+        indices[i]++;
+        for (int j = i + 1; j < k; j++) {
+            indices[j] = indices[j - 1] + 1;
+        }
+        return true;
+    }
+    
+    // Lexicographic rank of a sorted subset of {0, ..., n-1}
+    static uint64_t rank(const std::vector<int>& combo, int n) {
+        int k = static_cast<int>(combo.size());
+        uint64_t result = 0;
+        int next = 0;
+        for (int i = 0; i < k; i++) {
+            // Skip every subset whose i-th element is smaller than combo[i]
+            for (int c = next; c < combo[i]; c++) {
+                result += binomial(n - 1 - c, k - 1 - i);
+            }
+            next = combo[i] + 1;
+        }
+        return result;
+    }
+    
+    // Subset with the given lexicographic rank
+    static std::vector<int> unrank(uint64_t rank, int n, int k) {
+        if (rank >= binomial(n, k)) {
+            throw std::runtime_error("Combination rank " + std::to_string(rank) + " out of range");
+        }
+        
+        BinomialTable table(n);
+        std::vector<int> combo(k);
+        int c = 0;
+        for (int i = 0; i < k; i++) {
+            // Number of subsets that continue with c at position i
+            for (uint64_t count = table.at(n - 1 - c, k - 1 - i); rank >= count;
+                 count = table.at(n - 1 - c, k - 1 - i)) {
+                rank -= count;
+                c++;
+            }
+            combo[i] = c++;
+        }
+        return combo;
+    }
+};
+
+// Enumerates the k-subsets of {0, ..., n-1} in revolving-door order
+// (Knuth, TAOCP 7.2.1.3, Algorithm R): each subset differs from the
+// previous one by exactly one element leaving and one entering, so work
+// that depends on the subset can be updated instead of recomputed. The
+// order is defined recursively as R(n, k) = R(n-1, k) followed by
+// reverse(R(n-1, k-1)) with n-1 added, which also gives rank/unrank.
+class RevolvingDoorGenerator {
+private:
+    int n, k;
+    std::vector<int> c; // c[1..k] ascending, c[k+1] = n sentinel
+    std::vector<int> indices;
+    bool exhausted;
+    int removed = -1;
+    int added = -1;
+    
+    void publish() {
+        for (int j = 1; j <= k; j++) indices[j - 1] = c[j];
+    }
+    
+    bool finish() {
+        exhausted = true;
+        return false;
+    }
+
+public:
+    RevolvingDoorGenerator(int n, int k, uint64_t startRank = 0)
+        : n(n), k(k), c(k + 2), indices(k), exhausted(false) {
+        if (k < 0 || k > n) {
+            throw std::runtime_error("Invalid combination size " + std::to_string(k) + " of " + std::to_string(n));
+        }
+        if (startRank >= binomial(n, k)) {
+            exhausted = true;
+            return;
+        }
+        std::vector<int> start = unrank(startRank, n, k);
+        for (int j = 1; j <= k; j++) c[j] = start[j - 1];
+        c[k + 1] = n;
+        publish();
+    }
+    
+    bool done() const {
+        return exhausted;
+    }
+    
+    // Current subset, ascending
+    const std::vector<int>& current() const {
+        return indices;
+    }
+    
+    // Element that left / entered on the last call to next()
+    int lastRemoved() const {
+        return removed;
+    }
+    
+    int lastAdded() const {
+        return added;
+    }
+    
+    // Advance by one revolving-door step; false once the order is exhausted
+    bool next() {
+        if (exhausted) return false;
+        if (k == 0 || k == n) return finish();
+        
+        if (k == 1) {
+            if (c[1] + 1 >= n) return finish();
+            removed = c[1];
+            added = ++c[1];
+            publish();
+            return true;
+        }
+        
+        // R3: easy cases move only c[1]
+        if (k % 2 == 1 && c[1] + 1 < c[2]) {
+            removed = c[1];
+            added = ++c[1];
+            publish();
+            return true;
+        }
+        if (k % 2 == 0 && c[1] > 0) {
+            removed = c[1];
+            added = --c[1];
+            publish();
+            return true;
+        }
+        
+        int j = 2;
+        bool tryDecrease = k % 2 == 1;
+        while (j <= k) {
+            if (tryDecrease) {
+                // R4: here c[j] = c[j-1] + 1
+                if (c[j] >= j) {
+                    removed = c[j];
+                    added = j - 2;
+                    c[j] = c[j - 1];
+                    c[j - 1] = j - 2;
+                    publish();
+                    return true;
+                }
+                j++;
+                tryDecrease = false;
+            } else {
+                // R5: here c[j-1] = j - 2
+                if (c[j] + 1 < c[j + 1]) {
+                    removed = c[j - 1];
+                    added = c[j] + 1;
+                    c[j - 1] = c[j];
+                    c[j]++;
+                    publish();
+                    return true;
+                }
+                j++;
+                tryDecrease = true;
+            }
+        }
+        return finish();
+    }
+    
+    // Position of a sorted subset in revolving-door order
+    static uint64_t rank(const std::vector<int>& combo, int n) {
+        int k = static_cast<int>(combo.size());
+        // rank = offset + sign * (rank within the current sub-order); the
+        // arithmetic wraps mod 2^64 but the final value is in range
+        uint64_t offset = 0;
+        bool flipped = false;
+        while (k > 0 && k < n) {
+            if (combo[k - 1] < n - 1) {
+                n--;
+                continue;
+            }
+            uint64_t base = binomial(n - 1, k) + binomial(n - 1, k - 1) - 1;
+            offset = flipped ? offset - base : offset + base;
+            flipped = !flipped;
+            n--;
+            k--;
+        }
+        return offset;
+    }
+    
+    // Subset at the given position in revolving-door order
+    static std::vector<int> unrank(uint64_t rank, int n, int k) {
+        if (rank >= binomial(n, k)) {
+            throw std::runtime_error("Combination rank " + std::to_string(rank) + " out of range");
+        }
+        
+        std::vector<int> combo(k);
+        while (k > 0) {
+            if (k == n) {
+                for (int i = 0; i < k; i++) combo[i] = i;
+                break;
+            }
+            uint64_t head = binomial(n - 1, k);
+            if (rank >= head) {
+                // Second half runs through R(n-1, k-1) backwards
+                combo[k - 1] = n - 1;
+                rank = binomial(n - 1, k - 1) - 1 - (rank - head);
+                k--;
+            }
+            n--;
+        }
+        return combo;
+    }
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef FACTORIAL_TABLE_HPP
+#define FACTORIAL_TABLE_HPP
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bigint.hpp"
+#include "prime_field.hpp"
+#include "shared_field_table.hpp"
+
+// i! and 1 / i! modulo p for i = 0..n, built with n multiplications each
+// way and a single inversion. n must be below p.
+class FactorialTable {
+private:
+    std::vector<BigInt> factorials;
+    std::vector<BigInt> inverses;
+
+public:
+    FactorialTable(const PrimeField& field, size_t n) : factorials(n + 1), inverses(n + 1) {
+        if (!(BigInt(static_cast<long long>(n)) < field.modulus())) {
+            throw std::runtime_error("Factorials up to " + std::to_string(n) + " vanish modulo " + field.modulus().toString());
+        }
+        
+        factorials[0] = BigInt(1);
+        for (size_t i = 1; i <= n; i++) {
+            factorials[i] = field.mul(factorials[i - 1], BigInt(static_cast<long long>(i)));
+        }
+        inverses[n] = field.inverse(factorials[n]);
+        for (size_t i = n; i > 0; i--) {
+            inverses[i - 1] = field.mul(inverses[i], BigInt(static_cast<long long>(i)));
+        }
+    }
+    
+    // Largest i covered
+    size_t limit() const {
+        return factorials.size() - 1;
+    }
+    
+    const BigInt& factorial(size_t i) const {
+        return factorials[i];
+    }
+    
+    const BigInt& inverseFactorial(size_t i) const {
+        return inverses[i];
+    }
+    
+    // Process-wide table for the modulus covering at least 0..n
+    static std::shared_ptr<const FactorialTable> shared(const PrimeField& field, size_t n) {
+        return sharedFieldTable<FactorialTable>(field, n);
+    }
+};
+
+#endif
@@ -0,0 +1,433 @@
+#ifndef FIELD_POLYNOMIAL_HPP
+#define FIELD_POLYNOMIAL_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "bigint.hpp"
+#include "prime_field.hpp"
+
+// Polynomial with coefficients in a prime field, lowest degree first.
+// The zero polynomial is the empty vector.
+using Polynomial = std::vector<BigInt>;
+
+// Arithmetic on Polynomials over one prime field. Results are trimmed (no
+// zero leading coefficients).
+class PolynomialRing {
+private:
+    PrimeField field;
+    
+    // Unreduced product of a[0, n) and b[0, n) added into out[0, 2n - 1).
+    // Sums and differences are left unreduced too; the caller reduces once.
+    void karatsuba(const BigInt* a, const BigInt* b, size_t n, BigInt* out) const {
+        if (n < KaratsubaThreshold) {
+            for (size_t i = 0; i < n; i++) {
+                for (size_t j = 0; j < n; j++) {
+                    out[i + j] = out[i + j] + a[i] * b[j];
+                }
+            }
+            return;
+        }
+        
+        // a = a0 + x^m a1 with |a0| = m, |a1| = h >= m; same for b
+        size_t m = n / 2, h = n - m;
+        std::vector<BigInt> low(2 * m - 1), high(2 * h - 1), middle(2 * h - 1);
+        std::vector<BigInt> sumA(a + m, a + n), sumB(b + m, b + n);
+        for (size_t i = 0; i < m; i++) {
+            sumA[i] = sumA[i] + a[i];
+            sumB[i] = sumB[i] + b[i];
+        }
+        karatsuba(a, b, m, low.data());
+        karatsuba(a + m, b + m, h, high.data());
+        karatsuba(sumA.data(), sumB.data(), h, middle.data());
+        
+        for (size_t i = 0; i < low.size(); i++) {
+            out[i] = out[i] + low[i];
+            middle[i] = middle[i] - low[i];
+        }
+        for (size_t i = 0; i < high.size(); i++) {
+            out[i + 2 * m] = out[i + 2 * m] + high[i];
+            middle[i] = middle[i] - high[i];
+        }
+        for (size_t i = 0; i < middle.size(); i++) {
+            out[i + m] = out[i + m] + middle[i];
+        }
+    }
+    
+    // divide() for large operands: with rev(p) = x^deg p p(1/x),
+    //     rev(q) = rev(a) / rev(b) mod x^(deg a - deg b + 1)
+    // and r = a - b q, so the cost is a few multiplications
+    std::pair<Polynomial, Polynomial> divideByInverse(const Polynomial& a, const Polynomial& b) const {
+        size_t quotientSize = a.size() - b.size() + 1;
+        Polynomial reversedA(a.rbegin(), a.rbegin() + quotientSize);
+        Polynomial reversedB(b.rbegin(), b.rend());
+        
+        Polynomial quotient = multiply(reversedA, inverseSeries(reversedB, quotientSize));
+        quotient.resize(quotientSize, BigInt(0));
+        std::reverse(quotient.begin(), quotient.end());
+        trim(quotient);
+        
+        Polynomial remainder = subtract(a, multiply(b, quotient));
+        return {quotient, remainder};
+    }
+
+public:
+    // Factor size from which multiply() switches to Karatsuba
+    static constexpr size_t KaratsubaThreshold = 24;
+    
+    // Divisor and quotient size from which divide() uses Newton inversion
+    static constexpr size_t DivisionThreshold = 32;
+    
+    // Polynomial size from which evaluateMany() uses a subproduct tree
+    static constexpr size_t FastEvaluationThreshold = 256;
+    
+    // Point count from which interpolate() uses a subproduct tree
+    static constexpr size_t FastInterpolationThreshold = 192;
+    
+    explicit PolynomialRing(const PrimeField& primeField) : field(primeField) {}
+    
+    const PrimeField& baseField() const {
+        return field;
+    }
+    
+    static void trim(Polynomial& p) {
+        while (!p.empty() && p.back() == BigInt(0)) p.pop_back();
+    }
+    
+    // Degree, with -1 for the zero polynomial
+    static int degree(const Polynomial& p) {
+        return static_cast<int>(p.size()) - 1;
+    }
+    
+    // Horner's rule
+    BigInt evaluate(const Polynomial& p, const BigInt& x) const {
+        BigInt result(0);
+        for (size_t i = p.size(); i-- > 0; ) {
+            result = field.add(field.mul(result, x), p[i]);
+        }
+        return result;
+    }
+    
+    // p at every x: Horner's rule for short polynomials, otherwise
+    // subproduct-tree remainders over groups of about deg p points, for
+    // O(n log^2 deg p) instead of O(n deg p)
+    std::vector<BigInt> evaluateMany(const Polynomial& p, const std::vector<BigInt>& xs) const;
+    
+    // interpolate() for large k: with M = prod (x - x_j), the weights are
+    // y_i / M'(x_i), M' is evaluated on the tree, and the weighted sum of
+    // M / (x - x_i) is assembled bottom-up
+    Polynomial interpolateByTree(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys,
+                                 const std::vector<BigInt>& inverseDenominators) const;
+    
+    Polynomial add(const Polynomial& a, const Polynomial& b) const {
+        Polynomial result(std::max(a.size(), b.size()), BigInt(0));
+        for (size_t i = 0; i < result.size(); i++) {
+            result[i] = field.add(i < a.size() ? a[i] : BigInt(0), i < b.size() ? b[i] : BigInt(0));
+        }
+        trim(result);
+        return result;
+    }
+    
+    Polynomial subtract(const Polynomial& a, const Polynomial& b) const {
+        Polynomial result(std::max(a.size(), b.size()), BigInt(0));
+        for (size_t i = 0; i < result.size(); i++) {
+            result[i] = field.sub(i < a.size() ? a[i] : BigInt(0), i < b.size() ? b[i] : BigInt(0));
+        }
+        trim(result);
+        return result;
+    }
+    
+    Polynomial multiply(const Polynomial& a, const Polynomial& b) const {
+        if (a.empty() || b.empty()) return {};
+        
+        // Products are accumulated unreduced and each coefficient is
+        // reduced once at the end
+        Polynomial result(a.size() + b.size() - 1, BigInt(0));
+        const Polynomial& shorter = a.size() <= b.size() ? a : b;
+        const Polynomial& longer = a.size() <= b.size() ? b : a;
+        if (shorter.size() < KaratsubaThreshold) {
+            for (size_t i = 0; i < a.size(); i++) {
+                for (size_t j = 0; j < b.size(); j++) {
+                    result[i + j] = result[i + j] + a[i] * b[j];
+                }
+            }
+        } else {
+            // Cut the longer factor into pieces the size of the shorter one
+            size_t n = shorter.size();
+            std::vector<BigInt> piece(n), product(2 * n - 1);
+            for (size_t offset = 0; offset < longer.size(); offset += n) {
+                for (size_t i = 0; i < n; i++) {
+                    piece[i] = offset + i < longer.size() ? longer[offset + i] : BigInt(0);
+                }
+                std::fill(product.begin(), product.end(), BigInt(0));
+                karatsuba(piece.data(), shorter.data(), n, product.data());
+                for (size_t i = 0; i < product.size() && offset + i < result.size(); i++) {
+                    result[offset + i] = result[offset + i] + product[i];
+                }
+            }
+        }
+        for (auto& coefficient : result) coefficient = field.reduce(coefficient);
+        trim(result);
+        return result;
+    }
+    
+    // 1 / f mod x^n by Newton iteration, g <- g (2 - f g), doubling the
+    // number of correct coefficients each step. f(0) must be non-zero.
+    Polynomial inverseSeries(const Polynomial& f, size_t n) const {
+        if (f.empty() || f[0] == BigInt(0)) {
+            throw std::runtime_error("Power series has no inverse");
+        }
+        
+        Polynomial g{field.inverse(f[0])};
+        for (size_t length = 1; length < n; ) {
+            length = std::min(2 * length, n);
+            Polynomial low(f.begin(), f.begin() + std::min(length, f.size()));
+            Polynomial error = multiply(low, g);
+            error.resize(length, BigInt(0));
+            for (auto& coefficient : error) coefficient = field.sub(BigInt(0), coefficient);
+            error[0] = field.add(error[0], BigInt(2));
+            g = multiply(g, error);
+            g.resize(std::min(g.size(), length));
+        }
+        g.resize(n, BigInt(0));
+        trim(g);
+        return g;
+    }
+    
+    Polynomial derivative(const Polynomial& p) const {
+        Polynomial result;
+        for (size_t i = 1; i < p.size(); i++) {
+            result.push_back(field.mul(p[i], BigInt(static_cast<long long>(i))));
+        }
+        trim(result);
+        return result;
+    }
+    
+    // Quotient and remainder; long division for small divisors, otherwise
+    // the quotient comes from a power series inverse of the reversed divisor
+    std::pair<Polynomial, Polynomial> divide(const Polynomial& a, const Polynomial& b) const {
+        if (b.empty()) {
+            throw std::runtime_error("Polynomial division by zero");
+        }
+        if (a.size() < b.size()) return {{}, a};
+        if (b.size() >= DivisionThreshold && a.size() - b.size() + 1 >= DivisionThreshold) {
+            return divideByInverse(a, b);
+        }
+        
+        Polynomial remainder = a;
+        Polynomial quotient(a.size() - b.size() + 1, BigInt(0));
+        BigInt leadInverse = b.back() == BigInt(1) ? BigInt(1) : field.inverse(b.back());
+        
+        for (size_t i = quotient.size(); i-- > 0; ) {
+            BigInt factor = field.mul(remainder[i + b.size() - 1], leadInverse);
+            quotient[i] = factor;
+            if (factor == BigInt(0)) continue;
+            for (size_t j = 0; j < b.size(); j++) {
+                remainder[i + j] = field.sub(remainder[i + j], field.mul(factor, b[j]));
+            }
+        }
+        
+        remainder.resize(b.size() - 1);
+        trim(quotient);
+        trim(remainder);
+        return {quotient, remainder};
+    }
+    
+    // Coefficients of the unique polynomial of degree < k through k points
+    // with distinct x, by expanding the Lagrange form: O(k^2) and a single
+    // field inversion, or O(k log^2 k) over a subproduct tree for large k
+    Polynomial interpolate(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys) const {
+        return interpolate(xs, ys, {});
+    }
+    
+    // Same, with 1 / prod_{j != i} (x_i - x_j) supplied by the caller (for
+    // instance from a table of inverse differences) so no inversion is done.
+    // An empty vector means compute them.
+    Polynomial interpolate(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys,
+                           const std::vector<BigInt>& inverseDenominators) const {
+        size_t k = xs.size();
+        if (k >= FastInterpolationThreshold) return interpolateByTree(xs, ys, inverseDenominators);
+        
+        // M(x) = prod (x - x_j)
+        Polynomial master{BigInt(1)};
+        for (const auto& x : xs) {
+            master = multiply(master, {field.sub(BigInt(0), x), BigInt(1)});
+        }
+        
+        // M(x) / (x - x_i) by synthetic division, and its value at x_i
+        std::vector<Polynomial> bases(k, Polynomial(k));
+        std::vector<BigInt> denominators(k);
+        for (size_t i = 0; i < k; i++) {
+            Polynomial& basis = bases[i];
+            basis[k - 1] = master[k];
+            for (size_t j = k - 1; j > 0; j--) {
+                basis[j - 1] = field.add(master[j], field.mul(xs[i], basis[j]));
+            }
+            if (inverseDenominators.empty()) denominators[i] = evaluate(basis, xs[i]);
+        }
+        
+        std::vector<BigInt> inverses = inverseDenominators.empty() ? field.batchInverse(denominators) : inverseDenominators;
+        Polynomial result(k, BigInt(0));
+        for (size_t i = 0; i < k; i++) {
+            BigInt factor = field.mul(ys[i], inverses[i]);
+            for (size_t j = 0; j < k; j++) {
+                result[j] = field.add(result[j], field.mul(factor, bases[i][j]));
+            }
+        }
+        trim(result);
+        return result;
+    }
+};
+
+// Products of (x - x_i) over a balanced binary tree of points. Level 0
+// holds the linear factors and each level above multiplies adjacent pairs
+// (an odd node out moves up unchanged), so node j of level l covers points
+// [j 2^l, (j + 1) 2^l) and the root is prod (x - x_i).
+class SubproductTree {
+private:
+    const PolynomialRing& ring;
+    std::vector<BigInt> points;
+    std::vector<std::vector<Polynomial>> levels;
+    
+    // values[i] = r(points[i]) for the points under node (level, index),
+    // where r is reduced modulo that node's ancestors
+    void descend(const Polynomial& r, size_t level, size_t index, std::vector<BigInt>& values) const {
+        size_t begin = index << level;
+        size_t end = std::min(points.size(), (index + 1) << level);
+        if ((size_t(1) << level) <= LeafPoints) {
+            for (size_t i = begin; i < end; i++) {
+                values[i] = ring.evaluate(r, points[i]);
+            }
+            return;
+        }
+        
+        for (size_t child = 2 * index; child < std::min(2 * index + 2, levels[level - 1].size()); child++) {
+            const Polynomial& node = levels[level - 1][child];
+            if (r.size() < node.size()) {
+                descend(r, level - 1, child, values);
+            } else {
+                descend(ring.divide(r, node).second, level - 1, child, values);
+            }
+        }
+    }
+
+public:
+    // Nodes covering at most this many points are finished with Horner
+    static constexpr size_t LeafPoints = 8;
+    
+    SubproductTree(const PolynomialRing& polynomialRing, const std::vector<BigInt>& xs)
+        : ring(polynomialRing), points(xs) {
+        if (xs.empty()) {
+            throw std::runtime_error("Subproduct tree needs at least one point");
+        }
+        
+        const PrimeField& field = ring.baseField();
+        levels.emplace_back();
+        for (const auto& x : xs) {
+            levels.back().push_back({field.sub(BigInt(0), x), BigInt(1)});
+        }
+        while (levels.back().size() > 1) {
+            const std::vector<Polynomial>& below = levels.back();
+            std::vector<Polynomial> above;
+            above.reserve((below.size() + 1) / 2);
+            for (size_t i = 0; i + 1 < below.size(); i += 2) {
+                above.push_back(ring.multiply(below[i], below[i + 1]));
+            }
+            if (below.size() % 2 == 1) above.push_back(below.back());
+            levels.push_back(std::move(above));
+        }
+    }
+    
+    // prod (x - x_i)
+    const Polynomial& root() const {
+        return levels.back()[0];
+    }
+    
+    size_t height() const {
+        return levels.size();
+    }
+    
+    const std::vector<Polynomial>& level(size_t l) const {
+        return levels[l];
+    }
+    
+    const std::vector<BigInt>& xs() const {
+        return points;
+    }
+    
+    // sum_i c[i] * root / (x - x_i), by merging children bottom-up:
+    // r = r_left * M_right + r_right * M_left
+    Polynomial linearCombination(const std::vector<BigInt>& c) const {
+        std::vector<Polynomial> current;
+        current.reserve(c.size());
+        for (const auto& value : c) {
+            Polynomial leaf{value};
+            PolynomialRing::trim(leaf);
+            current.push_back(std::move(leaf));
+        }
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            std::vector<Polynomial> merged;
+            merged.reserve((current.size() + 1) / 2);
+            for (size_t i = 0; i + 1 < current.size(); i += 2) {
+                merged.push_back(ring.add(ring.multiply(current[i], levels[l][i + 1]),
+                                          ring.multiply(current[i + 1], levels[l][i])));
+            }
+            if (current.size() % 2 == 1) merged.push_back(std::move(current.back()));
+            current = std::move(merged);
+        }
+        return current[0];
+    }
+    
+    // p at every point, by reducing p down the tree
+    std::vector<BigInt> evaluate(const Polynomial& p) const {
+        std::vector<BigInt> values(points.size());
+        size_t top = levels.size() - 1;
+        if (p.size() < root().size()) {
+            descend(p, top, 0, values);
+        } else {
+            descend(ring.divide(p, root()).second, top, 0, values);
+        }
+        return values;
+    }
+};
+
+inline std::vector<BigInt> PolynomialRing::evaluateMany(const Polynomial& p, const std::vector<BigInt>& xs) const {
+    std::vector<BigInt> values;
+    values.reserve(xs.size());
+    if (p.size() < FastEvaluationThreshold) {
+        for (const auto& x : xs) values.push_back(evaluate(p, x));
+        return values;
+    }
+    
+    // A tree over more than deg p points only adds levels whose remainders
+    // are p itself, so evaluate in groups of about that many
+    size_t group = 1;
+    while (group < p.size()) group *= 2;
+    for (size_t begin = 0; begin < xs.size(); begin += group) {
+        std::vector<BigInt> chunk(xs.begin() + begin, xs.begin() + std::min(xs.size(), begin + group));
+        std::vector<BigInt> chunkValues = SubproductTree(*this, chunk).evaluate(p);
+        for (auto& value : chunkValues) values.push_back(std::move(value));
+    }
+    return values;
+}
+
+inline Polynomial PolynomialRing::interpolateByTree(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys,
+                                                    const std::vector<BigInt>& inverseDenominators) const {
+    SubproductTree tree(*this, xs);
+    std::vector<BigInt> inverses = inverseDenominators;
+    if (inverses.empty()) {
+        // M'(x_i) = prod_{j != i} (x_i - x_j)
+        inverses = field.batchInverse(tree.evaluate(derivative(tree.root())));
+    }
+    
+    std::vector<BigInt> c(xs.size());
+    for (size_t i = 0; i < xs.size(); i++) {
+        c[i] = field.mul(ys[i], inverses[i]);
+    }
+    Polynomial result = tree.linearCombination(c);
+    trim(result);
+    return result;
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef INCREMENTAL_LAGRANGE_HPP
+#define INCREMENTAL_LAGRANGE_HPP
+
+#include <vector>
+#include <stdexcept>
+#include "bigint.hpp"
+#include "prime_field.hpp"
+#include "word_product.hpp"
+
+// Field inverses of every pairwise x-difference and every x, for one share
+// set. Built once per solve with a single batched inversion and shared
+// read-only by all workers. Throws if two x-coordinates coincide or one is
+// zero, since neither can be handled incrementally.
+class InverseDifferenceTable {
+public:
+    PrimeField field;
+    int n;
+    std::vector<long long> xs;
+    std::vector<BigInt> inverseX;        // 1 / x_a
+    std::vector<BigInt> scaledY;         // y_a / x_a
+    std::vector<BigInt> inverseDiff;     // n x n, 1 / (x_a - x_b), zero on the diagonal
+    
+    InverseDifferenceTable(const PrimeField& primeField, const std::vector<long long>& x, const std::vector<BigInt>& y)
+        : field(primeField), n(static_cast<int>(x.size())), xs(x) {
+        std::vector<BigInt> values;
+        values.reserve(n + n * (n - 1) / 2);
+        for (int a = 0; a < n; a++) {
+            if (field.reduce(BigInt(xs[a])) == BigInt(0)) {
+                throw std::runtime_error("Share x-coordinate is zero in the field");
+            }
+            values.push_back(BigInt(xs[a]));
+        }
+        for (int a = 0; a < n; a++) {
+            for (int b = a + 1; b < n; b++) {
+                if (field.reduce(BigInt(xs[a] - xs[b])) == BigInt(0)) {
+                    throw std::runtime_error("Duplicate x-coordinate: " + std::to_string(xs[a]));
+                }
+                values.push_back(BigInt(xs[a] - xs[b]));
+            }
+        }
+        
+        std::vector<BigInt> inverses = field.batchInverse(values);
+        inverseX.assign(inverses.begin(), inverses.begin() + n);
+        inverseDiff.assign(static_cast<size_t>(n) * n, BigInt(0));
+        size_t next = n;
+        for (int a = 0; a < n; a++) {
+            for (int b = a + 1; b < n; b++) {
+                diff(a, b) = inverses[next];
+                diff(b, a) = field.sub(BigInt(0), inverses[next]);
+                next++;
+            }
+        }
+        for (int a = 0; a < n; a++) {
+            scaledY.push_back(field.mul(y[a], inverseX[a]));
+        }
+    }
+    
+    BigInt& diff(int a, int b) {
+        return inverseDiff[static_cast<size_t>(a) * n + b];
+    }
+    
+    const BigInt& diff(int a, int b) const {
+        return inverseDiff[static_cast<size_t>(a) * n + b];
+    }
+};
+
+// f(0) of the polynomial through a subset of the shares, kept up to date as
+// the subset changes one element at a time.
+//
+// With barycentric weights w_a = prod_{j in S, j != a} 1 / (x_a - x_j) and
+// P = prod_{j in S} (-x_j), the basis value is L_a(0) = -w_a * P / x_a, so
+//     f(0) = -P * sum_{a in S} w_a * y_a / x_a.
+// Swapping `out` for `in` rescales each surviving weight by
+// (x_a - x_out) / (x_a - x_in), builds w_in from k - 1 table entries and
+// rescales P, all O(k) multiplications and no inversions.
+class IncrementalLagrange {
+private:
+    const InverseDifferenceTable& table;
+    std::vector<int> members;
+    std::vector<BigInt> weights; // indexed by share, valid for members
+    BigInt product;
+    
+    BigInt weightFor(int a) const {
+        const PrimeField& field = table.field;
+        BigInt w(1);
+        for (int j : members) {
+            if (j != a) w = field.mul(w, table.diff(a, j));
+        }
+        return w;
+    }
+
+public:
+    explicit IncrementalLagrange(const InverseDifferenceTable& differences)
+        : table(differences), weights(differences.n) {}
+    
+    // Start over from an arbitrary subset, O(k^2)
+    void reset(const std::vector<int>& subset) {
+        const PrimeField& field = table.field;
+        members = subset;
+        WordProduct ids(field.modulus());
+        for (int a : members) {
+            weights[a] = weightFor(a);
+            ids.multiply(-table.xs[a]);
+        }
+        product = ids.result();
+    }
+    
+    // Replace share `out` with share `in`, O(k)
+    void swap(int out, int in) {
+        const PrimeField& field = table.field;
+        for (int& a : members) {
+            if (a == out) {
+                a = in;
+                continue;
+            }
+            weights[a] = field.mul(field.mul(weights[a], BigInt(table.xs[a] - table.xs[out])), table.diff(a, in));
+        }
+        weights[in] = weightFor(in);
+        
+        // P * (-x_in) / (-x_out)
+        product = field.mul(field.mul(product, BigInt(table.xs[in])), table.inverseX[out]);
+    }
+    
+    BigInt secret() const {
+        const PrimeField& field = table.field;
+        BigInt sum(0);
+        for (int a : members) {
+            sum = field.add(sum, field.mul(weights[a], table.scaledY[a]));
+        }
+        return field.sub(BigInt(0), field.mul(product, sum));
+    }
+};
+
+#endif
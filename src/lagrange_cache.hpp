@@ -0,0 +1,367 @@
+#ifndef LAGRANGE_CACHE_HPP
+#define LAGRANGE_CACHE_HPP
+
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include "bigint.hpp"
+#include "bigint_arena.hpp"
+#include "prime_field.hpp"
+#include "field_polynomial.hpp"
+#include "factorial_table.hpp"
+#include "word_product.hpp"
+#include "small_inverse_table.hpp"
+#include "lagrange_kernels.hpp"
+
+// Lagrange basis values L_i(0) for one x-set. They depend only on the
+// x-coordinates, so a recovery with cached weights is a k-term dot product.
+struct LagrangeWeights {
+    std::vector<long long> xs;      // canonical x-set, sorted ascending
+    std::vector<BigInt> weights;    // weights[i] belongs to xs[i]
+    BigInt denominator;             // 1 over a prime field, common denominator over the integers
+    
+    // f(0) = sum(weights[i] * ys[i]) / denominator, reduced mod p when a
+    // modulus is given; ys must follow the order of xs
+    BigInt combine(const std::vector<BigInt>& ys, const BigInt& modulus) const {
+        if (ys.size() != weights.size()) {
+            throw std::runtime_error("Expected " + std::to_string(weights.size()) + " y-values, got " + std::to_string(ys.size()));
+        }
+        
+        // Unreduced dot product, unrolled for the common thresholds
+        BigInt sum = dotProduct(weights, ys);
+        if (modulus != BigInt(0)) {
+            return PrimeField(modulus).reduce(sum);
+        }
+        return sum / denominator;
+    }
+};
+
+// LRU cache of Lagrange weights keyed by (modulus, sorted x-set). A zero
+// modulus selects exact integer arithmetic, where the weights are scaled
+// to a common denominator. Thread-safe; weights are computed outside the
+// lock and shared read-only.
+class LagrangeWeightCache {
+private:
+    struct Key {
+        BigInt modulus;
+        std::vector<long long> xs;
+        
+        bool operator==(const Key& other) const {
+            return xs == other.xs && modulus == other.modulus;
+        }
+    };
+    
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t h = key.modulus.fingerprint64();
+            for (long long x : key.xs) {
+                h ^= static_cast<uint64_t>(x) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+    
+    using Entry = std::pair<Key, std::shared_ptr<const LagrangeWeights>>;
+    
+    size_t maxEntries;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    mutable std::mutex mutex;
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+    
+    void evictOverflow() {
+        while (entries.size() > maxEntries) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+    
+public:
+    // Largest id difference read from the small inverse table
+    static constexpr long long SmallInverseSpan = 4096;
+    
+    // Most points for which table lookups beat one batched inversion
+    static constexpr size_t SmallInverseMaxPoints = 16;
+    
+    explicit LagrangeWeightCache(size_t capacity = 1024) : maxEntries(capacity) {}
+    
+    // Process-wide cache used by the solvers unless they are given another
+    static LagrangeWeightCache& shared() {
+        static LagrangeWeightCache instance;
+        return instance;
+    }
+    
+    void setCapacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex);
+        maxEntries = capacity;
+        evictOverflow();
+    }
+    
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return maxEntries;
+    }
+    
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+    
+    uint64_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hitCount;
+    }
+    
+    uint64_t misses() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return missCount;
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+    }
+    
+    // Weights for the x-set (any order), computed on a miss
+    std::shared_ptr<const LagrangeWeights> weights(std::vector<long long> xs, const BigInt& modulus) {
+        std::sort(xs.begin(), xs.end());
+        
+        Key key{modulus, xs};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(key);
+            if (found != index.end()) {
+                hitCount++;
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->second;
+            }
+            missCount++;
+        }
+        
+        // Computed in the caller's arena; only the finished weights and the
+        // key are copied to the heap, since they outlive that arena
+        std::shared_ptr<const LagrangeWeights> scratch = compute(xs, modulus);
+        BigIntHeapScope heap;
+        auto computed = std::make_shared<const LagrangeWeights>(*scratch);
+        if (maxEntries == 0) return computed;
+        
+        Key stored{modulus, std::move(xs)};
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(stored);
+        if (found != index.end()) {
+            return found->second->second; // another thread got there first
+        }
+        entries.emplace_front(std::move(stored), computed);
+        index.emplace(entries.front().first, entries.begin());
+        evictOverflow();
+        return computed;
+    }
+    
+    // f(0) of the polynomial through the given points (any order)
+    BigInt interpolateAtZero(const std::vector<std::pair<long long, BigInt>>& points, const BigInt& modulus) {
+        std::vector<std::pair<long long, BigInt>> sorted = points;
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        
+        std::vector<long long> xs;
+        std::vector<BigInt> ys;
+        xs.reserve(sorted.size());
+        ys.reserve(sorted.size());
+        for (const auto& point : sorted) {
+            xs.push_back(point.first);
+            ys.push_back(point.second);
+        }
+        
+        return weights(xs, modulus)->combine(ys, modulus);
+    }
+    
+    // True for a sorted x-set a, a + d, ..., a + (k - 1) d with k >= 3
+    static bool isProgression(const std::vector<long long>& xs) {
+        if (xs.size() < 3) return false;
+        long long step = xs[1] - xs[0];
+        for (size_t i = 2; i < xs.size(); i++) {
+            if (xs[i] - xs[i - 1] != step) return false;
+        }
+        return true;
+    }
+    
+    // Weights for x_i = a + i d over a prime field in O(k) with no
+    // per-weight inversion. Since x_i - x_j = (i - j) d,
+    //     L_i(0) = prod_{j != i} (-x_j) / (d^(k-1) i! (k-1-i)! (-1)^(k-1-i))
+    // where the numerators come from prefix and suffix products and the
+    // factorials from a shared table (for 1..k this is (-1)^i C(k, i+1)).
+    // A small d is inverted from the same table as (d - 1)! / d!.
+    // Returns null if k or d is not invertible mod p.
+    static std::shared_ptr<const LagrangeWeights> computeForProgression(const std::vector<long long>& xs, const BigInt& modulus) {
+        PrimeField field(modulus);
+        size_t k = xs.size();
+        long long gap = xs[1] - xs[0];
+        BigInt step = field.reduce(BigInt(gap));
+        if (step == BigInt(0) || !(BigInt(static_cast<long long>(k)) < modulus)) return nullptr;
+        bool smallGap = gap <= SmallInverseSpan && BigInt(gap) < modulus;
+        size_t tableSize = smallGap ? std::max<size_t>(k - 1, gap) : k - 1;
+        std::shared_ptr<const FactorialTable> factorials = FactorialTable::shared(field, tableSize);
+        
+        // suffix[i] = prod_{j >= i} (-x_j)
+        std::vector<BigInt> suffix(k + 1);
+        suffix[k] = BigInt(1);
+        for (size_t i = k; i-- > 0; ) {
+            suffix[i] = field.mul(suffix[i + 1], BigInt(-xs[i]));
+        }
+        
+        // 1 / d^(k-1)
+        BigInt inverseStep = smallGap ? field.mul(factorials->factorial(gap - 1), factorials->inverseFactorial(gap))
+                                      : field.inverse(step);
+        BigInt scale = field.pow(inverseStep, BigInt(static_cast<long long>(k - 1)));
+        
+        auto result = std::make_shared<LagrangeWeights>();
+        result->xs = xs;
+        BigInt prefix(1);
+        for (size_t i = 0; i < k; i++) {
+            BigInt weight = field.mul(field.mul(prefix, suffix[i + 1]), scale);
+            weight = field.mul(field.mul(weight, factorials->inverseFactorial(i)), factorials->inverseFactorial(k - 1 - i));
+            if ((k - 1 - i) % 2 == 1) weight = field.sub(BigInt(0), weight);
+            result->weights.push_back(weight);
+            prefix = field.mul(prefix, BigInt(-xs[i]));
+        }
+        result->denominator = BigInt(1);
+        return result;
+    }
+    
+    // Weights over a prime field without any inversion when every id
+    // difference is at most SmallInverseSpan: 1 / (x_i - x_j) is read from
+    // the shared small inverse table, the sign comes from the order
+    // (x_i - x_j < 0 exactly for j > i), and
+    //     L_i(0) = prod_{j != i} (-x_j) * (-1)^(k-1-i) * prod_{j != i} 1 / |x_i - x_j|
+    // This costs k(k-1) field multiplications, which beats the batched
+    // Fermat inversion of the general path for small k only. Returns null
+    // if the ids are too far apart, or a difference may vanish mod p.
+    static std::shared_ptr<const LagrangeWeights> computeWithInverseTable(const std::vector<long long>& xs, const BigInt& modulus) {
+        size_t k = xs.size();
+        long long span = k < 2 ? 0 : xs.back() - xs.front();
+        if (k < 2 || span > SmallInverseSpan || !(BigInt(span) < modulus)) return nullptr;
+        
+        PrimeField field(modulus);
+        std::shared_ptr<const SmallInverseTable> inverses = SmallInverseTable::shared(field, span);
+        
+        auto result = std::make_shared<LagrangeWeights>();
+        result->xs = xs;
+        for (size_t i = 0; i < k; i++) {
+            WordProduct numerator(modulus);
+            BigInt weight(1);
+            for (size_t j = 0; j < k; j++) {
+                if (i == j) continue;
+                numerator.multiply(-xs[j]);
+                weight = field.mul(weight, inverses->inverse(i < j ? xs[j] - xs[i] : xs[i] - xs[j]));
+            }
+            weight = field.mul(weight, numerator.result());
+            if ((k - 1 - i) % 2 == 1) weight = field.sub(BigInt(0), weight);
+            result->weights.push_back(weight);
+        }
+        result->denominator = BigInt(1);
+        return result;
+    }
+    
+    // Weights over a prime field in O(k log^2 k): with M = prod (x - x_j),
+    //     L_i(0) = M(0) / (-x_i * M'(x_i))
+    // and M' is evaluated at every x_i on a subproduct tree. Returns null
+    // if some x_i is 0 mod p, where that formula does not apply.
+    static std::shared_ptr<const LagrangeWeights> computeByTree(const std::vector<long long>& xs, const BigInt& modulus) {
+        PrimeField field(modulus);
+        PolynomialRing ring(field);
+        std::vector<BigInt> points;
+        points.reserve(xs.size());
+        for (long long x : xs) {
+            points.push_back(field.reduce(BigInt(x)));
+            if (points.back() == BigInt(0)) return nullptr;
+        }
+        
+        SubproductTree tree(ring, points);
+        std::vector<BigInt> slopes = tree.evaluate(ring.derivative(tree.root()));
+        std::vector<BigInt> denominators(xs.size());
+        for (size_t i = 0; i < xs.size(); i++) {
+            denominators[i] = field.mul(field.sub(BigInt(0), points[i]), slopes[i]);
+        }
+        std::vector<BigInt> inverses = field.batchInverse(denominators);
+        
+        auto result = std::make_shared<LagrangeWeights>();
+        result->xs = xs;
+        const BigInt& atZero = tree.root()[0];
+        for (const auto& inverse : inverses) {
+            result->weights.push_back(field.mul(atZero, inverse));
+        }
+        result->denominator = BigInt(1);
+        return result;
+    }
+    
+    // Compute weights for a sorted x-set without touching the cache
+    static std::shared_ptr<const LagrangeWeights> compute(const std::vector<long long>& xs, const BigInt& modulus) {
+        for (size_t i = 1; i < xs.size(); i++) {
+            if (xs[i] == xs[i - 1]) {
+                throw std::runtime_error("Duplicate x-coordinate: " + std::to_string(xs[i]));
+            }
+        }
+        
+        size_t k = xs.size();
+        if (modulus != BigInt(0) && isProgression(xs)) {
+            auto closed = computeForProgression(xs, modulus);
+            if (closed) return closed;
+        }
+        if (modulus != BigInt(0) && k <= SmallInverseMaxPoints) {
+            auto tabled = computeWithInverseTable(xs, modulus);
+            if (tabled) return tabled;
+        }
+        if (modulus != BigInt(0) && k >= PolynomialRing::FastInterpolationThreshold) {
+            auto fast = computeByTree(xs, modulus);
+            if (fast) return fast;
+        }
+        
+        auto result = std::make_shared<LagrangeWeights>();
+        result->xs = xs;
+        
+        // L_i(0) = prod_{j != i} (0 - x_j) / (x_i - x_j), with the ids
+        // multiplied in machine words before touching BigInt
+        std::vector<BigInt> numerators(k), denominators(k);
+        for (size_t i = 0; i < k; i++) {
+            WordProduct numerator(modulus), denominator(modulus);
+            for (size_t j = 0; j < k; j++) {
+                if (i == j) continue;
+                numerator.multiply(-xs[j]);
+                denominator.multiply(xs[i] - xs[j]);
+            }
+            numerators[i] = numerator.result();
+            denominators[i] = denominator.result();
+        }
+        
+        if (modulus != BigInt(0)) {
+            PrimeField field(modulus);
+            for (auto& denominator : denominators) denominator = field.reduce(denominator);
+            std::vector<BigInt> inverses = field.batchInverse(denominators);
+            for (size_t i = 0; i < k; i++) {
+                result->weights.push_back(field.mul(numerators[i], inverses[i]));
+            }
+            result->denominator = BigInt(1);
+            return result;
+        }
+        
+        // Over the integers, scale every weight to a common denominator
+        BigInt common(1);
+        for (const auto& denominator : denominators) {
+            common = BigInt::lcm(common, denominator);
+        }
+        for (size_t i = 0; i < k; i++) {
+            result->weights.push_back(numerators[i] * (common / denominators[i]));
+        }
+        result->denominator = common;
+        return result;
+    }
+};
+
+#endif
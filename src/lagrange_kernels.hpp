@@ -0,0 +1,125 @@
+#ifndef LAGRANGE_KERNELS_HPP
+#define LAGRANGE_KERNELS_HPP
+
+#include <array>
+#include <utility>
+#include <vector>
+#include "bigint.hpp"
+#include "prime_field.hpp"
+#include "word_product.hpp"
+#include "incremental_lagrange.hpp"
+
+// Interpolation kernels for the thresholds that dominate in practice.
+// Each is a template on K with state in std::array and every loop over
+// the K points expanded at compile time, so the hot path has no
+// containers, loop counters or size checks around the arithmetic. The
+// kernels are neither branch-free nor allocation-free: BigInt arithmetic
+// branches on carries and lengths, and every value still allocates its
+// digits, which the callers route into a per-worker arena.
+
+// Calls f(std::integral_constant<int, i>) for i = 0..K-1, fully unrolled
+template<int... I, typename F>
+inline void unrolledImpl(std::integer_sequence<int, I...>, F&& f) {
+    (f(std::integral_constant<int, I>{}), ...);
+}
+
+template<int K, typename F>
+inline void unrolled(F&& f) {
+    unrolledImpl(std::make_integer_sequence<int, K>{}, f);
+}
+
+// Thresholds with a dedicated kernel; the only list of them
+using FixedKernelSizes = std::integer_sequence<int, 2, 3, 4, 5, 7>;
+
+template<int... K, typename F>
+inline bool withFixedKernelImpl(std::integer_sequence<int, K...>, int k, F&& f) {
+    return ((k == K && (f(std::integral_constant<int, K>{}), true)) || ...);
+}
+
+// Calls f(std::integral_constant<int, k>) if k has a dedicated kernel;
+// returns whether it did
+template<typename F>
+inline bool withFixedKernel(int k, F&& f) {
+    return withFixedKernelImpl(FixedKernelSizes{}, k, f);
+}
+
+// sum a[i] * b[i] for i < K, without reducing
+template<int K>
+inline BigInt dotProduct(const BigInt* a, const BigInt* b) {
+    BigInt sum(0);
+    unrolled<K>([&](auto i) { sum = sum + a[i] * b[i]; });
+    return sum;
+}
+
+// Same for equally long vectors, dispatching to the kernel for their size
+inline BigInt dotProduct(const std::vector<BigInt>& a, const std::vector<BigInt>& b) {
+    BigInt sum(0);
+    if (withFixedKernel(static_cast<int>(a.size()), [&](auto size) {
+            sum = dotProduct<decltype(size)::value>(a.data(), b.data());
+        })) {
+        return sum;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        sum = sum + a[i] * b[i];
+    }
+    return sum;
+}
+
+// IncrementalLagrange for subsets of exactly K shares: the same O(K) swap
+// and formula, with members and weights held per slot in fixed arrays
+// and the final sum reduced once instead of per term.
+template<int K>
+class FixedLagrange {
+private:
+    const InverseDifferenceTable& table;
+    std::array<int, K> members;
+    std::array<BigInt, K> weights;  // weights[s] belongs to members[s]
+    BigInt product;
+    
+    BigInt weightFor(int slot) const {
+        const PrimeField& field = table.field;
+        BigInt w(1);
+        unrolled<K>([&](auto t) {
+            if (t != slot) w = field.mul(w, table.diff(members[slot], members[t]));
+        });
+        return w;
+    }
+
+public:
+    explicit FixedLagrange(const InverseDifferenceTable& differences) : table(differences) {}
+    
+    void reset(const std::vector<int>& subset) {
+        WordProduct ids(table.field.modulus());
+        unrolled<K>([&](auto s) { members[s] = subset[s]; });
+        unrolled<K>([&](auto s) {
+            weights[s] = weightFor(s);
+            ids.multiply(-table.xs[members[s]]);
+        });
+        product = ids.result();
+    }
+    
+    void swap(int out, int in) {
+        const PrimeField& field = table.field;
+        int slot = 0;
+        unrolled<K>([&](auto s) {
+            if (members[s] == out) slot = s;
+        });
+        members[slot] = in;
+        unrolled<K>([&](auto s) {
+            if (s == slot) return;
+            int a = members[s];
+            weights[s] = field.mul(field.mul(weights[s], BigInt(table.xs[a] - table.xs[out])), table.diff(a, in));
+        });
+        weights[slot] = weightFor(slot);
+        product = field.mul(field.mul(product, BigInt(table.xs[in])), table.inverseX[out]);
+    }
+    
+    BigInt secret() const {
+        const PrimeField& field = table.field;
+        BigInt sum(0);
+        unrolled<K>([&](auto s) { sum = sum + weights[s] * table.scaledY[members[s]]; });
+        return field.sub(BigInt(0), field.mul(product, field.reduce(sum)));
+    }
+};
+
+#endif
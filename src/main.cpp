@@ -4,51 +4,374 @@
 #include <string>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <optional>
 #include "json.hpp"
 #include "bigint.hpp"
 #include "polynomial_solver.hpp"
+#include "shamirs_solver.hpp"
+#include "batch_recovery.hpp"
+#include "share_splitter.hpp"
 
 using json = nlohmann::json;
 using namespace std;
 
-int main() {
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " [input.json] [options]" << endl;
+    cout << endl;
+    cout << "Without an input file the two assignment test cases are solved." << endl;
+    cout << endl;
+    cout << "Options:" << endl;
+    cout << "  -v, --verbose         Enable detailed output" << endl;
+    cout << "  -t, --time            Show execution time" << endl;
+    cout << "      --threads N       Search combinations on N threads (0 = all cores)" << endl;
+    cout << "      --cache-size N    Keep Lagrange weights for N x-sets (default 1024, 0 = off)" << endl;
+    cout << "      --decoder NAME    enum: vote over all k-subsets (default)" << endl;
+    cout << "                        rs: Berlekamp-Welch decoding, enumerating only as a fallback" << endl;
+    cout << "                        verify: interpolate one subset at a time, check it against all shares" << endl;
+    cout << "                        sample: verify random subsets until --confidence is reached" << endl;
+    cout << "      --confidence C    Target for --decoder sample: 1-2^-B or a probability (default 1-2^-40)" << endl;
+    cout << "      --max-samples N   Give up sampling after N subsets (default 1000000)" << endl;
+    cout << "      --seed N          Seed the sampler for a reproducible run" << endl;
+    cout << "      --quorum N        Stop enumerating once a secret has N votes" << endl;
+    cout << "      --deadline-ms N   Return the best answer so far after N milliseconds" << endl;
+    cout << "      --max-combinations N  Return the best answer so far after N combinations" << endl;
+    cout << "      --batch FILE      Recover every secret in FILE, all split to the same share ids" << endl;
+    cout << "      --split SECRET    Create shares of SECRET instead of solving (needs -k and -n)" << endl;
+    cout << "  -k, --threshold K     Shares needed to recover a split secret" << endl;
+    cout << "  -n, --shares N        Shares to create for --split" << endl;
+    cout << "  -o, --output FILE     Write split shares to FILE instead of stdout" << endl;
+    cout << "      --stats           Dump BigInt operation statistics (build with -DBIGINT_STATS)" << endl;
+    cout << "  -h, --help            Display this help message" << endl;
+}
+
+// Read the value following option argv[i] as a non-negative integer
+long long readCount(int argc, char* argv[], int& i) {
+    string option = argv[i];
+    if (i + 1 >= argc) {
+        throw runtime_error(option + " requires a value");
+    }
+    
+    string value = argv[++i];
+    size_t used = 0;
+    long long result = -1;
     try {
-        cout << "🔐 Catalog Placements Assignment - Shamir's Secret Sharing" << endl;
-        cout << "==========================================================" << endl;
-        cout << endl;
-        
-        // Process Test Case 1
-        cout << "📋 Processing Test Case 1..." << endl;
-        cout << "----------------------------" << endl;
-        
-        PolynomialSolver solver1;
-        BigInt secret1 = solver1.solve("testcases/testcase1.json");
-        
-        cout << "🎯 Test Case 1 Result:" << endl;
-        cout << "   Secret (c): " << secret1.toString() << endl;
-        cout << endl;
-        
-        // Process Test Case 2
-        cout << "📋 Processing Test Case 2..." << endl;
-        cout << "----------------------------" << endl;
-        
-        PolynomialSolver solver2;
-        BigInt secret2 = solver2.solve("testcases/testcase2.json");
-        
-        cout << "🎯 Test Case 2 Result:" << endl;
-        cout << "   Secret (c): " << secret2.toString() << endl;
-        cout << endl;
-        
-        // Final Output
-        cout << "🏆 FINAL RESULTS" << endl;
-        cout << "================" << endl;
-        cout << "Test Case 1 Secret: " << secret1.toString() << endl;
-        cout << "Test Case 2 Secret: " << secret2.toString() << endl;
-        
+        result = stoll(value, &used);
+    } catch (const exception&) {
+    }
+    if (used != value.size() || result < 0) {
+        throw runtime_error("Invalid value for " + option + ": " + value);
+    }
+    return result;
+}
+
+Decoder parseDecoder(const string& name) {
+    if (name == "enum") return Decoder::Enumerate;
+    if (name == "rs") return Decoder::ReedSolomon;
+    if (name == "verify") return Decoder::Verify;
+    if (name == "sample") return Decoder::Sample;
+    throw runtime_error("Unknown decoder: " + name + " (expected enum, rs, verify or sample)");
+}
+
+// Parse a confidence level, either "1-2^-B" or a probability in (0, 1),
+// into bits B such that the failure probability is 2^-B
+double parseConfidence(const string& value) {
+    size_t used = 0;
+    double bits = -1;
+    try {
+        if (value.rfind("1-2^-", 0) == 0) {
+            bits = stod(value.substr(5), &used);
+            used += 5;
+        } else {
+            double probability = stod(value, &used);
+            if (probability > 0 && probability < 1) bits = -log2(1 - probability);
+        }
+    } catch (const exception&) {
+    }
+    if (used != value.size() || !(bits > 0)) {
+        throw runtime_error("Invalid confidence: " + value + " (expected 1-2^-B or a probability in (0, 1))");
+    }
+    return bits;
+}
+
+void runAssignment() {
+    cout << "🔐 Catalog Placements Assignment - Shamir's Secret Sharing" << endl;
+    cout << "==========================================================" << endl;
+    cout << endl;
+
+    // Process Test Case 1
+    cout << "📋 Processing Test Case 1..." << endl;
+    cout << "----------------------------" << endl;
+
+    PolynomialSolver solver1;
+    BigInt secret1 = solver1.solve("testcases/testcase1.json");
+
+    cout << "🎯 Test Case 1 Result:" << endl;
+    cout << "   Secret (c): " << secret1.toString() << endl;
+    cout << endl;
+
+    // Process Test Case 2
+    cout << "📋 Processing Test Case 2..." << endl;
+    cout << "----------------------------" << endl;
+
+    PolynomialSolver solver2;
+    BigInt secret2 = solver2.solve("testcases/testcase2.json");
+
+    cout << "🎯 Test Case 2 Result:" << endl;
+    cout << "   Secret (c): " << secret2.toString() << endl;
+    cout << endl;
+
+    // Final Output
+    cout << "🏆 FINAL RESULTS" << endl;
+    cout << "================" << endl;
+    cout << "Test Case 1 Secret: " << secret1.toString() << endl;
+    cout << "Test Case 2 Secret: " << secret2.toString() << endl;
+}
+
+// Ctrl-C cancels the running solve, which then reports its best answer so
+// far; a second Ctrl-C terminates as usual
+CancellationToken interruptToken;
+
+extern "C" void onInterrupt(int) {
+    interruptToken.cancel();
+    signal(SIGINT, SIG_DFL);
+}
+
+// Installs a signal handler for its lifetime and puts back the handler it
+// replaced when the scope ends, including by an exception
+class SignalHandlerGuard {
+private:
+    int signum;
+    void (*previous)(int);
+
+public:
+    SignalHandlerGuard(int sig, void (*handler)(int)) : signum(sig), previous(signal(sig, handler)) {}
+
+    ~SignalHandlerGuard() {
+        if (previous != SIG_ERR) signal(signum, previous);
+    }
+
+    SignalHandlerGuard(const SignalHandlerGuard&) = delete;
+    SignalHandlerGuard& operator=(const SignalHandlerGuard&) = delete;
+};
+
+void runShamir(const string& filename, const SolveOptions& options) {
+    cout << "🔐 Shamir's Secret Sharing Algorithm" << endl;
+    cout << "====================================" << endl;
+    cout << "📂 Reading from: " << filename << endl << endl;
+
+    ShamirsSecretSharing solver(options);
+    SignalHandlerGuard interrupt(SIGINT, onInterrupt);
+    solver.solve(filename);
+}
+
+// Read a share value given as a decimal string or a JSON integer
+BigInt readValue(const json& value) {
+    if (value.is_string()) return BigInt(value.get<string>());
+    if (value.is_number_integer()) return BigInt(value.get<long long>());
+    throw runtime_error("Share values must be decimal strings or integers, got " + value.dump());
+}
+
+// Batch file: {"ids": [x...], "secrets": [[y per id]...], "prime": optional}
+void runBatch(const string& filename, const SolveOptions& options) {
+    cout << "🔐 Shamir's Secret Sharing - Batch Recovery" << endl;
+    cout << "===========================================" << endl;
+    cout << "📂 Reading from: " << filename << endl << endl;
+    
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + filename);
+    }
+    json data;
+    file >> data;
+    file.close();
+    
+    vector<long long> ids = data["ids"].get<vector<long long>>();
+    BigInt prime(data.value("prime", string(PrimeField::DefaultModulus)));
+    vector<vector<BigInt>> ys;
+    for (const auto& row : data["secrets"]) {
+        ys.emplace_back();
+        for (const auto& value : row) {
+            ys.back().push_back(readValue(value));
+        }
+    }
+    
+    cout << "📊 Configuration:" << endl;
+    cout << "   Shares per secret: " << ids.size() << endl;
+    cout << "   Secrets: " << ys.size() << endl << endl;
+    
+    BatchRecovery batch(ids, prime, options.threads);
+    vector<BigInt> secrets = batch.recover(ys);
+    
+    cout << "🎯 Recovered secrets:" << endl;
+    for (size_t i = 0; i < secrets.size(); i++) {
+        cout << "   Secret " << (i + 1) << ": " << secrets[i].toString() << endl;
+    }
+}
+
+struct SplitRequest {
+    string secret;
+    int k = 0;
+    int n = 0;
+    string output;      // empty = stdout
+};
+
+// Write shares in the input format solve() reads; without an output file
+// only the JSON is printed, so it can be piped
+void runSplit(const SplitRequest& request, const SolveOptions& options) {
+    if (request.k < 1 || request.n < 1) {
+        throw runtime_error("--split needs --threshold K and --shares N");
+    }
+    
+    ShareSplitter splitter{BigInt(PrimeField::DefaultModulus), options.threads};
+    auto shares = splitter.split(BigInt(request.secret), request.k, request.n);
+    
+    json data;
+    data["n"] = request.n;
+    data["k"] = request.k;
+    data["shares"] = json::array();
+    for (const auto& share : shares) {
+        data["shares"].push_back({{"id", share.first}, {"value", share.second.toString()}});
+    }
+    
+    if (request.output.empty()) {
+        cout << data.dump(2) << endl;
+        return;
+    }
+    
+    ofstream file(request.output);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + request.output);
+    }
+    file << data.dump(2) << endl;
+    
+    cout << "🔐 Shamir's Secret Sharing - Split" << endl;
+    cout << "==================================" << endl;
+    cout << "✅ Wrote " << request.n << " shares (any " << request.k << " recover the secret) to " << request.output << endl;
+}
+
+void printStats() {
+    cout << endl;
+#ifdef BIGINT_STATS
+    BigIntStats::report(cout);
+#else
+    cout << "📊 BigInt statistics are not compiled in; rebuild with -DBIGINT_STATS" << endl;
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    string filename;
+    string batchFile;
+    optional<SplitRequest> split;
+    SolveOptions options;
+    options.cancellation = interruptToken;
+    bool showTime = false;
+    bool showStats = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--verbose" || arg == "-v") {
+                options.verbose = true;
+            } else if (arg == "--time" || arg == "-t") {
+                showTime = true;
+            } else if (arg == "--threads") {
+                options.threads = static_cast<int>(readCount(argc, argv, i));
+            } else if (arg == "--cache-size") {
+                LagrangeWeightCache::shared().setCapacity(readCount(argc, argv, i));
+            } else if (arg == "--decoder") {
+                if (i + 1 >= argc) {
+                    throw runtime_error(arg + " requires a value");
+                }
+                options.decoder = parseDecoder(argv[++i]);
+            } else if (arg.rfind("--decoder=", 0) == 0) {
+                options.decoder = parseDecoder(arg.substr(10));
+            } else if (arg == "--confidence") {
+                if (i + 1 >= argc) {
+                    throw runtime_error(arg + " requires a value");
+                }
+                options.confidenceBits = parseConfidence(argv[++i]);
+            } else if (arg == "--max-samples") {
+                options.maxSamples = readCount(argc, argv, i);
+            } else if (arg == "--seed") {
+                options.seed = readCount(argc, argv, i);
+            } else if (arg == "--quorum") {
+                options.quorum = static_cast<int>(readCount(argc, argv, i));
+            } else if (arg == "--deadline-ms") {
+                options.deadlineMs = readCount(argc, argv, i);
+            } else if (arg == "--max-combinations") {
+                options.maxCombinations = readCount(argc, argv, i);
+            } else if (arg == "--batch") {
+                if (i + 1 >= argc) {
+                    throw runtime_error(arg + " requires a value");
+                }
+                batchFile = argv[++i];
+            } else if (arg == "--split") {
+                if (i + 1 >= argc) {
+                    throw runtime_error(arg + " requires a value");
+                }
+                if (!split) split.emplace();
+                split->secret = argv[++i];
+            } else if (arg == "--threshold" || arg == "-k") {
+                if (!split) split.emplace();
+                split->k = static_cast<int>(readCount(argc, argv, i));
+            } else if (arg == "--shares" || arg == "-n") {
+                if (!split) split.emplace();
+                split->n = static_cast<int>(readCount(argc, argv, i));
+            } else if (arg == "--output" || arg == "-o") {
+                if (i + 1 >= argc) {
+                    throw runtime_error(arg + " requires a value");
+                }
+                if (!split) split.emplace();
+                split->output = argv[++i];
+            } else if (arg == "--stats") {
+                showStats = true;
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                cerr << "❌ Unknown option: " << arg << endl;
+                printUsage(argv[0]);
+                return 1;
+            } else {
+                filename = arg;
+            }
+        }
+    } catch (const exception& e) {
+        cerr << "❌ " << e.what() << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    try {
+        if (split) {
+            if (split->secret.empty()) {
+                throw runtime_error("--threshold, --shares and --output need --split SECRET");
+            }
+            runSplit(*split, options);
+        } else if (!batchFile.empty()) {
+            runBatch(batchFile, options);
+        } else if (filename.empty()) {
+            runAssignment();
+        } else {
+            runShamir(filename, options);
+        }
     } catch (const exception& e) {
         cerr << "❌ Error: " << e.what() << endl;
         return 1;
     }
-    
+
+    if (showTime) {
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << endl << "⏱️  Execution time: " << elapsed.count() << " ms" << endl;
+    }
+
+    if (showStats) {
+        printStats();
+    }
+
     return 0;
 }
@@ -10,6 +10,7 @@
 #include <cctype>
 #include "json.hpp"
 #include "bigint.hpp"
+#include "lagrange_cache.hpp"
 
 using json = nlohmann::json;
 using namespace std;
@@ -25,8 +26,14 @@ private:
     
     vector<Point> points;
     int n, k;
+    LagrangeWeightCache* weightCache = &LagrangeWeightCache::shared();
     
 public:
+    // Use a dedicated Lagrange weight cache instead of the shared one
+    void setWeightCache(LagrangeWeightCache& cache) {
+        weightCache = &cache;
+    }
+    
     // Convert a character to its numeric value in given base
     int charToDigit(char c) {
         if (c >= '0' && c <= '9') {
@@ -62,7 +69,6 @@ public:
     
     // Lagrange interpolation to find polynomial value at x=0 (constant term)
     BigInt lagrangeInterpolation(const vector<Point>& points) {
-        BigInt result("0");
         int n = points.size();
         
         cout << "   Using Lagrange interpolation with " << n << " points:" << endl;
@@ -70,30 +76,16 @@ public:
         for (int i = 0; i < n; i++) {
             cout << "     Point " << (i+1) << ": (" << points[i].x.toString() 
                  << ", " << points[i].y.toString() << ")" << endl;
-            
-            BigInt term = points[i].y;
-            BigInt numerator("1");
-            BigInt denominator("1");
-            
-            // Calculate Lagrange basis polynomial L_i(0)
-            for (int j = 0; j < n; j++) {
-                if (i != j) {
-                    // For x = 0: (0 - x_j) / (x_i - x_j) = -x_j / (x_i - x_j)
-                    numerator = numerator * (BigInt("0") - points[j].x);
-                    denominator = denominator * (points[i].x - points[j].x);
-                }
-            }
-            
-            // Handle division for the term
-            // Since we're working with integers, we need to be careful with division
-            // In practice, for Shamir's secret sharing, the result should be an integer
-            if (denominator != BigInt("0")) {
-                term = term * numerator / denominator;
-                result = result + term;
-            }
         }
         
-        return result;
+        // Weights are exact rationals over a common denominator; the sum is
+        // divided once so no term is truncated on its own
+        vector<pair<long long, BigInt>> xy;
+        xy.reserve(points.size());
+        for (const auto& point : points) {
+            xy.emplace_back(point.x.toLongLong(), point.y);
+        }
+        return weightCache->interpolateAtZero(xy, BigInt(0));
     }
     
     // Alternative method using matrix approach (Gaussian elimination)
@@ -161,7 +153,7 @@ public:
         });
         
         // We need exactly k points to solve the polynomial
-        if (points.size() < k) {
+        if (static_cast<int>(points.size()) < k) {
             throw runtime_error("Not enough points to solve polynomial. Need " + 
                               to_string(k) + ", got " + to_string(points.size()));
         }
@@ -0,0 +1,84 @@
+#ifndef PRIME_FIELD_HPP
+#define PRIME_FIELD_HPP
+
+#include <vector>
+#include <stdexcept>
+#include "bigint.hpp"
+
+// Arithmetic modulo a prime p on BigInt values. Every result is reduced
+// into [0, p); inputs may be any integer.
+class PrimeField {
+private:
+    BigInt p;
+    
+public:
+    // Modulus for shares unless a file names its own: 2^127 - 1
+    static constexpr const char* DefaultModulus = "170141183460469231731687303715884105727";
+    
+    explicit PrimeField(const BigInt& modulus) : p(modulus) {}
+    
+    const BigInt& modulus() const {
+        return p;
+    }
+    
+    BigInt reduce(const BigInt& a) const {
+        BigInt r = a % p;
+        if (r < BigInt(0)) r = r + p;
+        return r;
+    }
+    
+    BigInt add(const BigInt& a, const BigInt& b) const {
+        return reduce(a + b);
+    }
+    
+    BigInt sub(const BigInt& a, const BigInt& b) const {
+        return reduce(a - b);
+    }
+    
+    BigInt mul(const BigInt& a, const BigInt& b) const {
+        return reduce(a * b);
+    }
+    
+    BigInt pow(BigInt base, BigInt exp) const {
+        BigInt result(1);
+        base = reduce(base);
+        while (exp > BigInt(0)) {
+            if (exp % BigInt(2) == BigInt(1)) {
+                result = mul(result, base);
+            }
+            exp = exp / BigInt(2);
+            base = mul(base, base);
+        }
+        return result;
+    }
+    
+    // Multiplicative inverse via Fermat's little theorem
+    BigInt inverse(const BigInt& a) const {
+        BigInt r = reduce(a);
+        if (r == BigInt(0)) {
+            throw std::runtime_error("Zero has no inverse modulo " + p.toString());
+        }
+        return pow(r, p - BigInt(2));
+    }
+    
+    // Invert every element with a single field inversion (Montgomery's
+    // trick: prefix products, one inverse, then unwind)
+    std::vector<BigInt> batchInverse(const std::vector<BigInt>& values) const {
+        std::vector<BigInt> prefix(values.size());
+        BigInt running(1);
+        for (size_t i = 0; i < values.size(); i++) {
+            prefix[i] = running;
+            running = mul(running, values[i]);
+        }
+        
+        BigInt inv = inverse(running);
+        std::vector<BigInt> result(values.size());
+        for (size_t i = values.size(); i-- > 0; ) {
+            result[i] = mul(inv, prefix[i]);
+            inv = mul(inv, values[i]);
+        }
+        return result;
+    }
+};
+
+#endif
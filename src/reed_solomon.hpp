@@ -0,0 +1,135 @@
+#ifndef REED_SOLOMON_HPP
+#define REED_SOLOMON_HPP
+
+#include <vector>
+#include <utility>
+#include "bigint.hpp"
+#include "prime_field.hpp"
+#include "field_polynomial.hpp"
+
+// Outcome of decoding one share set. On failure the other fields are empty.
+struct DecodeResult {
+    bool success = false;
+    Polynomial polynomial;          // f with deg f < k, lowest coefficient first
+    BigInt secret;                  // f(0)
+    std::vector<int> errorPositions; // indices of shares with y != f(x)
+};
+
+// Berlekamp-Welch decoding of Shamir shares viewed as a Reed-Solomon
+// codeword. With n shares, threshold k and at most e = floor((n - k) / 2)
+// wrong values, the error locator E (monic, degree e, zero at every bad x)
+// and Q = f * E (degree < k + e) satisfy
+//     Q(x_i) = y_i * E(x_i)     for every share i,
+// a linear system in the k + 2e unknown coefficients. Any solution yields
+// f = Q / E, so one Gaussian elimination (O(n^3)) recovers the polynomial,
+// and the bad shares are the points f misses. Decoding fails, rather than
+// returning a wrong answer, when more than e shares are wrong in a way the
+// system can detect; the caller should then fall back to enumeration.
+class BerlekampWelchDecoder {
+private:
+    PrimeField field;
+    PolynomialRing ring;
+    
+    // Solve A z = b in place; returns false if the system is inconsistent.
+    // Free variables are set to zero.
+    bool solveLinearSystem(std::vector<std::vector<BigInt>>& rows, std::vector<BigInt>& solution) const {
+        size_t equations = rows.size();
+        size_t unknowns = rows.empty() ? 0 : rows[0].size() - 1;
+        std::vector<int> pivotColumn;
+        size_t rank = 0;
+        
+        for (size_t col = 0; col < unknowns && rank < equations; col++) {
+            size_t pivot = rank;
+            while (pivot < equations && rows[pivot][col] == BigInt(0)) pivot++;
+            if (pivot == equations) continue;
+            std::swap(rows[rank], rows[pivot]);
+            
+            BigInt inverse = field.inverse(rows[rank][col]);
+            for (size_t j = col; j <= unknowns; j++) {
+                rows[rank][j] = field.mul(rows[rank][j], inverse);
+            }
+            for (size_t i = 0; i < equations; i++) {
+                if (i == rank || rows[i][col] == BigInt(0)) continue;
+                BigInt factor = rows[i][col];
+                for (size_t j = col; j <= unknowns; j++) {
+                    rows[i][j] = field.sub(rows[i][j], field.mul(factor, rows[rank][j]));
+                }
+            }
+            pivotColumn.push_back(static_cast<int>(col));
+            rank++;
+        }
+        
+        // A zero row with a non-zero right-hand side has no solution
+        for (size_t i = rank; i < equations; i++) {
+            if (rows[i][unknowns] != BigInt(0)) return false;
+        }
+        
+        solution.assign(unknowns, BigInt(0));
+        for (size_t i = 0; i < rank; i++) {
+            solution[pivotColumn[i]] = rows[i][unknowns];
+        }
+        return true;
+    }
+
+public:
+    explicit BerlekampWelchDecoder(const PrimeField& primeField) : field(primeField), ring(primeField) {}
+    
+    // Most wrong shares that n shares with threshold k can correct
+    static int errorBound(int n, int k) {
+        return n < k ? -1 : (n - k) / 2;
+    }
+    
+    // Decode shares (xs[i], ys[i]) of a polynomial of degree < k. The x
+    // values must be distinct in the field.
+    DecodeResult decode(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys, int k) const {
+        DecodeResult result;
+        int n = static_cast<int>(xs.size());
+        int e = errorBound(n, k);
+        if (k < 1 || e < 0) return result;
+        
+        // Unknowns: q_0..q_{k+e-1}, then e_0..e_{e-1} (E's leading 1 is fixed)
+        //     sum q_j x^j - y * sum e_j x^j = y * x^e
+        int unknowns = k + 2 * e;
+        std::vector<std::vector<BigInt>> rows(n, std::vector<BigInt>(unknowns + 1));
+        for (int i = 0; i < n; i++) {
+            BigInt x = field.reduce(xs[i]);
+            BigInt y = field.reduce(ys[i]);
+            BigInt power(1);
+            for (int j = 0; j < k + e; j++) {
+                rows[i][j] = power;
+                if (j < e) rows[i][k + e + j] = field.sub(BigInt(0), field.mul(y, power));
+                if (j == e) rows[i][unknowns] = field.mul(y, power);
+                power = field.mul(power, x);
+            }
+        }
+        
+        std::vector<BigInt> solution;
+        if (!solveLinearSystem(rows, solution)) return result;
+        
+        Polynomial q(solution.begin(), solution.begin() + k + e);
+        Polynomial locator(solution.begin() + k + e, solution.end());
+        locator.push_back(BigInt(1));
+        PolynomialRing::trim(q);
+        
+        auto division = ring.divide(q, locator);
+        if (!division.second.empty() || PolynomialRing::degree(division.first) >= k) return result;
+        
+        result.polynomial = std::move(division.first);
+        for (int i = 0; i < n; i++) {
+            if (ring.evaluate(result.polynomial, xs[i]) != field.reduce(ys[i])) {
+                result.errorPositions.push_back(i);
+            }
+        }
+        if (static_cast<int>(result.errorPositions.size()) > e) {
+            result.errorPositions.clear();
+            result.polynomial.clear();
+            return result;
+        }
+        
+        result.secret = result.polynomial.empty() ? BigInt(0) : result.polynomial[0];
+        result.success = true;
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SECURE_RANDOM_HPP
+#define SECURE_RANDOM_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <bcrypt.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "bcrypt")
+#endif
+#else
+#include <unistd.h>
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/random.h>
+#endif
+#endif
+
+// Fill out with bytes from the operating system's CSPRNG: BCryptGenRandom
+// on Windows, getentropy elsewhere. Fails closed: an error throws rather
+// than falling back to a weaker source.
+inline void secureRandomBytes(uint8_t* out, size_t length) {
+#ifdef _WIN32
+    while (length > 0) {
+        ULONG chunk = static_cast<ULONG>(std::min<size_t>(length, 1 << 30));
+        NTSTATUS status = BCryptGenRandom(nullptr, out, chunk, BCRYPT_USE_SYSTEM_PREFERRED_RNG);
+        if (!BCRYPT_SUCCESS(status)) {
+            throw std::runtime_error("BCryptGenRandom failed with status " + std::to_string(status));
+        }
+        out += chunk;
+        length -= chunk;
+    }
+#else
+    // getentropy hands out at most 256 bytes per call
+    while (length > 0) {
+        size_t chunk = std::min<size_t>(length, 256);
+        if (getentropy(out, chunk) != 0) {
+            throw std::runtime_error(std::string("getentropy failed: ") + std::strerror(errno));
+        }
+        out += chunk;
+        length -= chunk;
+    }
+#endif
+}
+
+#endif
@@ -6,24 +6,184 @@
 #include <vector>
 #include <string>
 #include <map>
-#include <set>
 #include <algorithm>
 #include <regex>
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <functional>
+#include <optional>
+#include <random>
+#include <numeric>
+#include <cmath>
 #include "json.hpp"
 #include "bigint.hpp"
+#include "bigint_arena.hpp"
+#include "combinations.hpp"
+#include "share_mask.hpp"
+#include "bigint_table.hpp"
+#include "work_stealing.hpp"
+#include "lagrange_cache.hpp"
+#include "incremental_lagrange.hpp"
+#include "lagrange_kernels.hpp"
+#include "reed_solomon.hpp"
+#include "solve_budget.hpp"
 
 using json = nlohmann::json;
 using namespace std;
 
+// How the secret and the wrong shares are recovered
+enum class Decoder {
+    Enumerate,      // vote over every k-subset
+    ReedSolomon,    // Berlekamp-Welch, enumerating only beyond its error bound
+    Verify,         // interpolate one subset, check it against every share
+    Sample          // verify random subsets until confident (RANSAC)
+};
+
+struct SolveOptions {
+    bool verbose = false;
+    int threads = 1;    // workers for the combination search; 0 = all cores
+    Decoder decoder = Decoder::Enumerate;
+    
+    // Sampling decoder: stop once the chance of never having drawn an
+    // all-honest subset is below 2^-confidenceBits
+    double confidenceBits = 40;
+    uint64_t maxSamples = 1000000;
+    optional<uint64_t> seed;    // unset = random
+    
+    // Enumeration: stop once a secret has this many votes (0 = off)
+    int quorum = 0;
+    
+    // Budget; when it runs out the best answer so far is returned
+    long long deadlineMs = 0;       // wall-clock limit, 0 = none
+    uint64_t maxCombinations = 0;   // combinations or samples, 0 = no limit
+    CancellationToken cancellation; // cancel() from any thread to stop early
+};
+
+// Outcome of a solve. After a budget stop it describes the best candidate
+// found so far.
+struct SolveResult {
+    BigInt secret;
+    vector<BigInt> wrongShares;     // ids of shares inconsistent with the secret
+    uint64_t support = 0;           // votes (enumeration) or agreeing shares
+    uint64_t examined = 0;          // combinations or samples checked
+    uint64_t total = 0;             // C(n, k), saturated; 0 when not searched
+    double confidence = 1.0;        // estimated probability the secret is right
+    StopReason stopReason = StopReason::Completed;
+    
+    double explored() const {
+        return total == 0 ? 1.0 : min(1.0, static_cast<double>(examined) / total);
+    }
+    
+    // True if the search ended on a budget rather than on an answer
+    bool interrupted() const {
+        return stopReason == StopReason::Deadline || stopReason == StopReason::WorkLimit ||
+               stopReason == StopReason::Cancelled;
+    }
+};
+
 class ShamirsSecretSharing {
 private:
     int n, k;
     vector<pair<BigInt, BigInt>> shares;
-    BigInt PRIME = BigInt("170141183460469231731687303715884105727"); // 2^127 - 1
+    vector<long long> shareX;   // share ids as machine integers, for weight products
+    BigInt PRIME = BigInt(PrimeField::DefaultModulus);
     bool verbose;
+    SolveOptions options;
+    LagrangeWeightCache* weightCache = &LagrangeWeightCache::shared();
+    unique_ptr<InverseDifferenceTable> differences;
+    BigIntArena setupArena;     // scratch for the single-threaded setup steps
+    mutex outputMutex;
+    unique_ptr<SolveBudget> budget;
+    
+    // Votes for one candidate secret. firstRank is the enumeration rank of
+    // the earliest combination that produced it, used to break ties the
+    // same way whether the search ran serially or in parallel, and
+    // representative is that combination. witness is the earliest one
+    // without a share at x = 0: such a share makes a combination
+    // interpolate to its own value whatever the other shares are, so only
+    // a witness shows which polynomial the secret came from.
+    struct SecretVote {
+        int count = 0;
+        uint64_t firstRank = numeric_limits<uint64_t>::max();
+        uint64_t witnessRank = numeric_limits<uint64_t>::max();
+        ShareMask representative;
+        ShareMask witness;
+        
+        void add(uint64_t rank, const ShareMask& combo, bool pinned) {
+            count++;
+            if (rank < firstRank) {
+                firstRank = rank;
+                representative = combo;
+            }
+            if (!pinned && rank < witnessRank) {
+                witnessRank = rank;
+                witness = combo;
+            }
+        }
+        
+        void merge(const SecretVote& other) {
+            count += other.count;
+            if (other.firstRank < firstRank) {
+                firstRank = other.firstRank;
+                representative = other.representative;
+            }
+            if (other.witnessRank < witnessRank) {
+                witnessRank = other.witnessRank;
+                witness = other.witness;
+            }
+        }
+        
+        bool hasWitness() const {
+            return witnessRank != numeric_limits<uint64_t>::max();
+        }
+    };
+    
+    // Keyed by the secret's limbs; secrets are only converted to decimal
+    // for output
+    using SecretTally = BigIntTable<SecretVote>;
+    
+    // Most combinations tallied between merges into the shared tally
+    static constexpr uint64_t TallyMergeInterval = 256;
+    
+    // Shared state of an enumeration that stops once the outcome is
+    // decided. Workers fold their chunk tallies into `tally` under `mutex`,
+    // tracking the leader and an upper bound on every other secret's count.
+    struct TallyProgress {
+        mutex lock;
+        SecretTally tally;
+        uint64_t total = 0;
+        uint64_t merged = 0;    // combinations folded into tally
+        size_t leader = SIZE_MAX;   // position in tally.entries()
+        int runnerUpBound = 0;  // >= the count of every secret but the leader
+        atomic<bool> stop{false};
+        bool decided = false;   // no rival can catch the leader any more
+        bool quorumReached = false;
+    };
+    
+    // Polynomial reconstructed from one subset, with the number of shares
+    // it passes through; order is its rank or sample number
+    struct Candidate {
+        int agreement = -1;
+        uint64_t order = numeric_limits<uint64_t>::max();
+        Polynomial polynomial;
+    };
+    vector<BigInt> reducedX, reducedY;  // shares reduced into the field
+    vector<int> zeroShares;     // positions of shares with x = 0 in the field
     
 public:
-    ShamirsSecretSharing(bool verboseMode = false) : verbose(verboseMode) {}
+    ShamirsSecretSharing(bool verboseMode = false) : verbose(verboseMode) {
+        options.verbose = verboseMode;
+    }
+    
+    ShamirsSecretSharing(const SolveOptions& solveOptions)
+        : verbose(solveOptions.verbose), options(solveOptions) {}
+    
+    // Use a dedicated Lagrange weight cache instead of the shared one
+    void setWeightCache(LagrangeWeightCache& cache) {
+        weightCache = &cache;
+    }
     
     // Evaluate mathematical expressions from JSON
     BigInt evaluateExpression(const string& expr) {
@@ -36,7 +196,7 @@ public:
         }
         
         // Check for sum function
-        regex sumPattern(R"(sum$$(\d+),(\d+)$$)");
+        regex sumPattern(R"(sum\((\d+),(\d+)\))");
         smatch match;
         if (regex_search(cleanExpr, match, sumPattern)) {
             BigInt a(match[1].str());
@@ -45,7 +205,7 @@ public:
         }
         
         // Check for multiply function
-        regex multiplyPattern(R"(multiply$$(\d+),(\d+)$$)");
+        regex multiplyPattern(R"(multiply\((\d+),(\d+)\))");
         if (regex_search(cleanExpr, match, multiplyPattern)) {
             BigInt a(match[1].str());
             BigInt b(match[2].str());
@@ -53,7 +213,7 @@ public:
         }
         
         // Check for divide function
-        regex dividePattern(R"(divide$$(\d+),(\d+)$$)");
+        regex dividePattern(R"(divide\((\d+),(\d+)\))");
         if (regex_search(cleanExpr, match, dividePattern)) {
             BigInt a(match[1].str());
             BigInt b(match[2].str());
@@ -61,7 +221,7 @@ public:
         }
         
         // Check for lcm function
-        regex lcmPattern(R"(lcm$$(\d+),(\d+)$$)");
+        regex lcmPattern(R"(lcm\((\d+),(\d+)\))");
         if (regex_search(cleanExpr, match, lcmPattern)) {
             BigInt a(match[1].str());
             BigInt b(match[2].str());
@@ -69,7 +229,7 @@ public:
         }
         
         // Check for hcf/gcd function
-        regex hcfPattern(R"((?:hcf|gcd)$$(\d+),(\d+)$$)");
+        regex hcfPattern(R"((?:hcf|gcd)\((\d+),(\d+)\))");
         if (regex_search(cleanExpr, match, hcfPattern)) {
             BigInt a(match[1].str());
             BigInt b(match[2].str());
@@ -77,7 +237,7 @@ public:
         }
         
         // Check for power function
-        regex powerPattern(R"(power$$(\d+),(\d+)$$)");
+        regex powerPattern(R"(power\((\d+),(\d+)\))");
         if (regex_search(cleanExpr, match, powerPattern)) {
             BigInt base(match[1].str());
             BigInt exp(match[2].str());
@@ -92,19 +252,14 @@ public:
         throw runtime_error("Unknown expression format: " + expr);
     }
     
-    // Greatest Common Divisor
-    BigInt gcd(BigInt a, BigInt b) {
-        while (b != BigInt("0")) {
-            BigInt temp = b;
-            b = a % b;
-            a = temp;
-        }
-        return a;
+    // Greatest Common Divisor (binary GCD, Lehmer for large operands)
+    BigInt gcd(const BigInt& a, const BigInt& b) {
+        return BigInt::gcd(a, b);
     }
     
     // Least Common Multiple
-    BigInt lcm(BigInt a, BigInt b) {
-        return (a * b) / gcd(a, b);
+    BigInt lcm(const BigInt& a, const BigInt& b) {
+        return BigInt::lcm(a, b);
     }
     
     // Power function
@@ -140,74 +295,153 @@ public:
     }
     
     // Lagrange interpolation to find constant term
-    BigInt lagrangeInterpolation(const vector<pair<BigInt, BigInt>>& points) {
-        BigInt result("0");
-        int n = points.size();
-        
+    BigInt lagrangeInterpolation(const vector<pair<long long, BigInt>>& points) {
         if (verbose) {
+            lock_guard<mutex> lock(outputMutex);
             cout << "    Using points: ";
             for (const auto& point : points) {
-                cout << "(" << point.first.toString() << ", " << point.second.toString() << ") ";
+                cout << "(" << point.first << ", " << point.second.toString() << ") ";
             }
             cout << endl;
         }
         
-        for (int i = 0; i < n; i++) {
-            BigInt term = points[i].second;
-            BigInt numerator("1");
-            BigInt denominator("1");
-            
-            for (int j = 0; j < n; j++) {
-                if (i != j) {
-                    numerator = (numerator * (BigInt("0") - points[j].first)) % PRIME;
-                    denominator = (denominator * (points[i].first - points[j].first)) % PRIME;
-                }
-            }
-            
-            // Handle negative numbers
-            if (numerator < BigInt("0")) {
-                numerator = numerator + PRIME;
-            }
-            if (denominator < BigInt("0")) {
-                denominator = denominator + PRIME;
+        // The basis weights depend only on the x-set; reuse them across calls
+        return weightCache->interpolateAtZero(points, PRIME);
+    }
+    
+    // Interpolate the shares selected by combo. All temporaries live in the
+    // arena, which is reset once the secret has been copied out or the
+    // interpolation has thrown.
+    BigInt interpolateCombination(const vector<int>& combo, BigIntArena& arena) {
+        BigInt secret;
+        {
+            BigIntArena::ResetScope scope(arena);
+            vector<pair<long long, BigInt>> points;
+            points.reserve(combo.size());
+            for (int idx : combo) {
+                points.emplace_back(shareX[idx], shares[idx].second);
             }
-            
-            BigInt inv = modInverse(denominator, PRIME);
-            term = ((term * numerator) % PRIME * inv) % PRIME;
-            result = (result + term) % PRIME;
+            secret = lagrangeInterpolation(points);
         }
-        
-        return result;
+        return secret;
     }
     
-    // Generate all combinations of k elements from n elements
-    void generateCombinations(vector<int>& arr, int k, int start, vector<int>& current, 
-                            vector<vector<int>>& result) {
-        if (current.size() == k) {
-            result.push_back(current);
+    // Run body over [0, total) split across the given number of workers,
+    // each with its own arena. A single thread walks the range in order.
+    // Once the budget is exhausted or `done` holds, no more chunks start.
+    void forEachRankRange(uint64_t total, int threads,
+                          const function<void(uint64_t, uint64_t, int, BigIntArena&)>& body,
+                          const function<bool()>& done = nullptr) {
+        vector<unique_ptr<BigIntArena>> arenas;
+        for (int i = 0; i < threads; i++) {
+            arenas.push_back(make_unique<BigIntArena>());
+        }
+        
+        if (threads <= 1) {
+            body(0, total, 0, *arenas[0]);
             return;
         }
         
-        for (int i = start; i <= arr.size() - (k - current.size()); i++) {
-            current.push_back(arr[i]);
-            generateCombinations(arr, k, i + 1, current, result);
-            current.pop_back();
+        // Small chunks keep stealing effective; each combination is costly
+        uint64_t grain = max<uint64_t>(1, min<uint64_t>(256, total / (static_cast<uint64_t>(threads) * 16)));
+        WorkStealingRanges ranges(total, threads, grain);
+        ranges.run([&](uint64_t begin, uint64_t end, int worker) {
+            body(begin, end, worker, *arenas[worker]);
+        }, [&] {
+            return budget->exhausted() || (done && done());
+        });
+    }
+    
+    void recordVote(SecretTally& tally, const BigInt& secret, uint64_t rank, const ShareMask& combo) {
+        bool pinned = any_of(zeroShares.begin(), zeroShares.end(), [&](int idx) { return combo.test(idx); });
+        tally[secret].add(rank, combo, pinned);
+        
+        if (verbose) {
+            lock_guard<mutex> lock(outputMutex);
+            cout << "  Combination ";
+            combo.forEach([](int idx) { cout << (idx + 1) << " "; });
+            cout << "→ Secret: " << secret.toString() << endl;
         }
     }
     
-    vector<vector<int>> getCombinations(int n, int k) {
-        vector<int> indices(n);
-        for (int i = 0; i < n; i++) {
-            indices[i] = i;
+    // Interpolate every combination with rank in [begin, end) into tally.
+    // With an inverse-difference table the combinations are walked in
+    // revolving-door order and each secret is updated in O(k) from the
+    // previous one; otherwise each is interpolated from scratch. Returns
+    // how many were tallied, fewer than requested if the budget ran out.
+    uint64_t tallyRange(uint64_t begin, uint64_t end, SecretTally& tally, BigIntArena& arena) {
+        if (differences) {
+            return tallyRangeIncremental(begin, end, tally, arena);
         }
         
-        vector<vector<int>> combinations;
-        vector<int> current;
-        generateCombinations(indices, k, 0, current, combinations);
-        return combinations;
+        CombinationGenerator generator(n, k, begin);
+        for (uint64_t rank = begin; rank < end; rank++, generator.next()) {
+            if (!budget->spend()) return rank - begin;
+            const vector<int>& combo = generator.current();
+            try {
+                BigInt secret = interpolateCombination(combo, arena);
+                recordVote(tally, secret, rank, ShareMask::of(combo));
+            } catch (const exception& e) {
+                if (verbose) {
+                    lock_guard<mutex> lock(outputMutex);
+                    cout << "  Combination ";
+                    for (int idx : combo) cout << (idx + 1) << " ";
+                    cout << "→ Failed: " << e.what() << endl;
+                }
+                continue;
+            }
+        }
+        return end - begin;
+    }
+    
+    // Thresholds with a fixed-size kernel get their own instantiation
+    uint64_t tallyRangeIncremental(uint64_t begin, uint64_t end, SecretTally& tally, BigIntArena& arena) {
+        uint64_t tallied = 0;
+        if (withFixedKernel(k, [&](auto size) {
+                tallied = tallyRangeWith<FixedLagrange<decltype(size)::value>>(begin, end, tally, arena);
+            })) {
+            return tallied;
+        }
+        return tallyRangeWith<IncrementalLagrange>(begin, end, tally, arena);
+    }
+    
+    template<typename Lagrange>
+    uint64_t tallyRangeWith(uint64_t begin, uint64_t end, SecretTally& tally, BigIntArena& arena) {
+        RevolvingDoorGenerator generator(n, k, begin);
+        Lagrange lagrange(*differences);
+        ShareMask combo = ShareMask::of(generator.current());
+        
+        for (uint64_t rank = begin; rank < end; rank++) {
+            if (!budget->spend()) return rank - begin;
+            BigInt secret;
+            {
+                BigIntArena::ResetScope scope(arena);
+                if (rank == begin) {
+                    lagrange.reset(generator.current());
+                } else {
+                    generator.next();
+                    lagrange.swap(generator.lastRemoved(), generator.lastAdded());
+                    combo.reset(generator.lastRemoved());
+                    combo.set(generator.lastAdded());
+                }
+                secret = lagrange.secret();
+            }
+            
+            if (verbose) {
+                lock_guard<mutex> lock(outputMutex);
+                cout << "    Using points: ";
+                for (int idx : generator.current()) {
+                    cout << "(" << shares[idx].first.toString() << ", " << shares[idx].second.toString() << ") ";
+                }
+                cout << endl;
+            }
+            recordVote(tally, secret, rank, combo);
+        }
+        return end - begin;
     }
     
-    void solve(const string& filename) {
+    // Parse the share file into n, k and shares, echoing the configuration
+    void loadShares(const string& filename) {
         // Read JSON file
         ifstream file(filename);
         if (!file.is_open()) {
@@ -228,15 +462,21 @@ public:
         
         // Parse and evaluate shares
         shares.clear();
+        shareX.clear();
         auto jsonShares = data["shares"];
         
         cout << "🔢 Evaluating shares:" << endl;
         for (int i = 0; i < n; i++) {
             int id = jsonShares[i]["id"];
             string valueExpr = jsonShares[i]["value"];
-            BigInt value = evaluateExpression(valueExpr);
+            BigInt value;
+            {
+                BigIntArena::ResetScope scope(setupArena);
+                value = evaluateExpression(valueExpr);
+            }
             
             shares.push_back({BigInt(to_string(id)), value});
+            shareX.push_back(id);
             cout << "   Share " << id << ": " << valueExpr;
             if (verbose || valueExpr != value.toString()) {
                 cout << " = " << value.toString();
@@ -244,111 +484,611 @@ public:
             cout << endl;
         }
         cout << endl;
+    }
+    
+    // Precompute inverse x-differences so subsets can be interpolated
+    // without inversions; zero or repeated share ids leave the table unset
+    // and callers fall back to per-combination interpolation. The table is
+    // built in the setup arena and only the finished table is copied out.
+    void buildDifferenceTable() {
+        differences.reset();
+        try {
+            BigIntArena::ResetScope scope(setupArena);
+            vector<BigInt> ys;
+            for (const auto& share : shares) {
+                ys.push_back(share.second);
+            }
+            InverseDifferenceTable table(PrimeField(PRIME), shareX, ys);
+            BigIntHeapScope heap;
+            differences = make_unique<InverseDifferenceTable>(table);
+        } catch (const exception& e) {
+            if (verbose) {
+                cout << "   Incremental interpolation unavailable: " << e.what() << endl;
+            }
+        }
+    }
+    
+    // Ids of the shares at the given positions
+    vector<BigInt> shareIds(const vector<int>& positions) const {
+        vector<BigInt> ids;
+        for (int idx : positions) ids.push_back(shares[idx].first);
+        return ids;
+    }
+    
+    void printFinalResults(const SolveResult& result) {
+        cout << endl << "🎯 FINAL RESULTS" << endl;
+        cout << "=================" << endl;
+        cout << "🔑 SECRET: " << result.secret.toString() << endl;
+        
+        if (!result.wrongShares.empty()) {
+            cout << "⚠️  WRONG SHARES DETECTED: ";
+            for (size_t i = 0; i < result.wrongShares.size(); i++) {
+                cout << "Share " << result.wrongShares[i].toString();
+                if (i < result.wrongShares.size() - 1) cout << ", ";
+            }
+            cout << endl;
+        } else {
+            cout << "✅ NO WRONG SHARES DETECTED" << endl;
+        }
         
-        // Generate all combinations
-        vector<vector<int>> combinations = getCombinations(n, k);
-        map<string, int> secretCounts;
-        map<string, vector<int>> secretToCombination;
+        if (result.interrupted()) {
+            cout << "⏱️  BEST SO FAR (" << describe(result.stopReason) << "): explored "
+                 << (100.0 * result.explored()) << "% of the search, confidence at least ~" << result.confidence << endl;
+        }
+    }
+    
+    // Estimated probability that the candidate agreeing with `agreement`
+    // shares is right after checking `draws` subsets: certain when no other
+    // polynomial can fit as many shares, otherwise the chance that at least
+    // one subset was all honest, treating the subsets as random draws
+    double confidenceFor(int agreement, uint64_t draws) const {
+        if (agreement >= n - max(BerlekampWelchDecoder::errorBound(n, k), 0)) return 1.0;
+        return 1.0 - exp2(-static_cast<double>(draws) * bitsPerSample(agreement));
+    }
+    
+    // Decode the shares as a Reed-Solomon codeword. Returns false, having
+    // printed nothing final, when there are more wrong shares than the
+    // decoder can correct.
+    bool solveReedSolomon(SolveResult& result) {
+        int bound = BerlekampWelchDecoder::errorBound(n, k);
+        cout << "🧬 Decoding as a Reed-Solomon codeword (corrects up to " << max(bound, 0) << " wrong shares)..." << endl;
         
-        cout << "🔍 Testing " << combinations.size() << " combinations..." << endl;
+        // Decoded in the setup arena; the result is copied out to the heap
+        DecodeResult decoded;
+        try {
+            BigIntArena::ResetScope scope(setupArena);
+            vector<BigInt> xs, ys;
+            for (const auto& share : shares) {
+                xs.push_back(share.first);
+                ys.push_back(share.second);
+            }
+            DecodeResult scratch = BerlekampWelchDecoder(PrimeField(PRIME)).decode(xs, ys, k);
+            BigIntHeapScope heap;
+            decoded = scratch;
+        } catch (const exception& e) {
+            if (verbose) {
+                cout << "   Decoding failed: " << e.what() << endl;
+            }
+        }
         
-        // Try each combination
-        int validCombinations = 0;
-        for (const auto& combo : combinations) {
-            try {
-                vector<pair<BigInt, BigInt>> points;
-                for (int idx : combo) {
-                    points.push_back(shares[idx]);
-                }
-                
-                BigInt secret = lagrangeInterpolation(points);
-                string secretStr = secret.toString();
-                
-                secretCounts[secretStr]++;
-                if (secretToCombination.find(secretStr) == secretToCombination.end()) {
-                    secretToCombination[secretStr] = combo;
-                }
-                validCombinations++;
-                
-                if (verbose) {
-                    cout << "  Combination ";
-                    for (int idx : combo) cout << (idx + 1) << " ";
-                    cout << "→ Secret: " << secretStr << endl;
-                }
-            } catch (const exception& e) {
-                if (verbose) {
-                    cout << "  Combination ";
-                    for (int idx : combo) cout << (idx + 1) << " ";
-                    cout << "→ Failed: " << e.what() << endl;
+        if (!decoded.success) {
+            cout << "   Too many wrong shares to decode; falling back to enumeration" << endl << endl;
+            return false;
+        }
+        
+        cout << "✅ Secret found: " << decoded.secret.toString() << endl;
+        if (verbose) {
+            cout << "   Polynomial coefficients:";
+            for (const auto& coefficient : decoded.polynomial) cout << " " << coefficient.toString();
+            cout << endl;
+        }
+        
+        int consistent = n - static_cast<int>(decoded.errorPositions.size());
+        result.secret = decoded.secret;
+        result.wrongShares = shareIds(decoded.errorPositions);
+        result.support = consistent;
+        printFinalResults(result);
+        
+        cout << "📈 CONSISTENT SHARES: " << consistent << "/" << n
+             << " (" << (100.0 * consistent / n) << "%)" << endl;
+        return true;
+    }
+    
+    // Interpolate the full polynomial through the shares in combo and count
+    // the shares it passes through (O(k^2 + n*k), no inversions when the
+    // inverse-difference table is available)
+    int checkCandidate(const vector<int>& combo, const PolynomialRing& ring, Polynomial& candidate) {
+        const PrimeField& field = ring.baseField();
+        vector<BigInt> subsetX, subsetY, inverseDenominators;
+        vector<char> member(n, 0);
+        for (int idx : combo) {
+            subsetX.push_back(reducedX[idx]);
+            subsetY.push_back(reducedY[idx]);
+            member[idx] = 1;
+        }
+        if (differences) {
+            for (int a : combo) {
+                BigInt product(1);
+                for (int b : combo) {
+                    if (b != a) product = field.mul(product, differences->diff(a, b));
                 }
-                continue;
+                inverseDenominators.push_back(product);
             }
         }
+        candidate = ring.interpolate(subsetX, subsetY, inverseDenominators);
         
-        // Find the most common secret
-        string correctSecret;
-        int maxCount = 0;
+        // The subset itself agrees by construction
+        int agreement = k;
+        for (int i = 0; i < n; i++) {
+            if (!member[i] && ring.evaluate(candidate, reducedX[i]) == reducedY[i]) agreement++;
+        }
         
-        for (const auto& pair : secretCounts) {
-            if (pair.second > maxCount) {
-                maxCount = pair.second;
-                correctSecret = pair.first;
+        if (verbose) {
+            lock_guard<mutex> lock(outputMutex);
+            cout << "  Combination ";
+            for (int idx : combo) cout << (idx + 1) << " ";
+            cout << "→ Secret: " << (candidate.empty() ? string("0") : candidate[0].toString())
+                 << ", agrees with " << agreement << "/" << n << " shares" << endl;
+        }
+        return agreement;
+    }
+    
+    // checkCandidate inside the worker's arena, keeping the result in best
+    // if it has more support (ties go to the lower order). Returns the
+    // agreement, or -1 if the subset could not be interpolated.
+    int checkAndKeep(const vector<int>& combo, uint64_t order, const PolynomialRing& ring,
+                     BigIntArena& arena, Candidate& best, mutex* bestMutex = nullptr) {
+        int agreement = -1;
+        try {
+            BigIntArena::ResetScope scope(arena);
+            Polynomial candidate;
+            agreement = checkCandidate(combo, ring, candidate);
+            
+            unique_lock<mutex> lock;
+            if (bestMutex) lock = unique_lock<mutex>(*bestMutex);
+            if (agreement > best.agreement || (agreement == best.agreement && order < best.order)) {
+                BigIntHeapScope heap;
+                best.agreement = agreement;
+                best.order = order;
+                best.polynomial.assign(candidate.begin(), candidate.end());
+            }
+        } catch (const exception& e) {
+            if (verbose) {
+                lock_guard<mutex> lock(outputMutex);
+                cout << "  Combination ";
+                for (int idx : combo) cout << (idx + 1) << " ";
+                cout << "→ Failed: " << e.what() << endl;
+            }
+        }
+        return agreement;
+    }
+    
+    // Reduce the shares into the field and build the difference table
+    // before checking candidates
+    void prepareCandidateChecks(bool withDifferences = true) {
+        PrimeField field(PRIME);
+        reducedX.clear();
+        reducedY.clear();
+        for (const auto& share : shares) {
+            BigInt x, y;
+            {
+                BigIntArena::ResetScope scope(setupArena);
+                x = field.reduce(share.first);
+                y = field.reduce(share.second);
             }
+            reducedX.push_back(move(x));
+            reducedY.push_back(move(y));
         }
+        if (withDifferences) buildDifferenceTable();
+    }
+    
+    // Fill result with the winning candidate's secret and the shares it
+    // misses, and print them
+    void reportCandidate(const Candidate& winner, const PolynomialRing& ring, SolveResult& result) {
+        result.secret = winner.polynomial.empty() ? BigInt(0) : winner.polynomial[0];
+        result.support = winner.agreement;
+        cout << "✅ Secret found: " << result.secret.toString() << endl;
         
-        if (correctSecret.empty()) {
-            throw runtime_error("Could not determine the correct secret");
+        // The agreement set is the valid shares
+        vector<int> wrongShares;
+        {
+            BigIntArena::ResetScope scope(setupArena);
+            for (int i = 0; i < n; i++) {
+                if (ring.evaluate(winner.polynomial, reducedX[i]) != reducedY[i]) wrongShares.push_back(i);
+            }
         }
+        result.wrongShares = shareIds(wrongShares);
+        printFinalResults(result);
+    }
+    
+    // Reconstruct the full polynomial from one k-subset at a time and
+    // evaluate it at every share. The first polynomial that agrees with at
+    // least n - floor((n-k)/2) shares is accepted: two such polynomials
+    // would share k points and so be equal. If no subset gets there, the
+    // best-supported polynomial is reported.
+    SolveResult solveByVerification() {
+        int bound = max(BerlekampWelchDecoder::errorBound(n, k), 0);
+        int required = n - bound;
+        PolynomialRing ring{PrimeField(PRIME)};
+        prepareCandidateChecks();
         
-        cout << "✅ Secret found: " << correctSecret << endl;
-        cout << "   Appears in " << maxCount << " out of " << combinations.size() << " combinations" << endl;
+        uint64_t totalCombinations = binomial(n, k);
+        int threads = resolveThreadCount(options.threads);
+        cout << "🔍 Verifying candidates from up to " << totalCombinations << " combinations";
+        if (threads > 1) cout << " on " << threads << " threads";
+        cout << " (accepting " << required << "/" << n << " agreeing shares)..." << endl;
         
-        // Find wrong shares
-        set<int> validShareIndices;
+        vector<Candidate> best(threads);
+        atomic<bool> accepted{false};
+        atomic<uint64_t> checked{0};
         
-        for (const auto& combo : combinations) {
-            try {
-                vector<pair<BigInt, BigInt>> points;
-                for (int idx : combo) {
-                    points.push_back(shares[idx]);
+        forEachRankRange(totalCombinations, threads, [&](uint64_t begin, uint64_t end, int worker, BigIntArena& arena) {
+            CombinationGenerator generator(n, k, begin);
+            for (uint64_t rank = begin; rank < end; rank++, generator.next()) {
+                if (accepted.load(memory_order_relaxed) || !budget->spend()) return;
+                checked++;
+                if (checkAndKeep(generator.current(), rank, ring, arena, best[worker]) >= required) {
+                    accepted = true;
                 }
+            }
+        }, [&] { return accepted.load(memory_order_relaxed); });
+        
+        const Candidate* winner = nullptr;
+        for (const auto& candidate : best) {
+            if (candidate.agreement < 0) continue;
+            if (!winner || candidate.agreement > winner->agreement ||
+                (candidate.agreement == winner->agreement && candidate.order < winner->order)) {
+                winner = &candidate;
+            }
+        }
+        if (!winner) {
+            throw runtime_error(budget->exhausted() ? string("Budget exhausted before a candidate was found (") +
+                                describe(budget->reason()) + ")" : string("Could not determine the correct secret"));
+        }
+        
+        SolveResult result;
+        result.examined = checked.load();
+        result.total = totalCombinations;
+        if (accepted) {
+            result.stopReason = StopReason::Decided;
+        } else if (budget->exhausted()) {
+            result.stopReason = budget->reason();
+            result.confidence = confidenceFor(winner->agreement, result.examined);
+        } else {
+            // Every subset was checked, so nothing fits more shares
+            cout << "   No candidate reached " << required << " agreeing shares; reporting the best supported one" << endl;
+        }
+        reportCandidate(*winner, ring, result);
+        
+        cout << "📈 AGREEING SHARES: " << winner->agreement << "/" << n
+             << " (" << (100.0 * winner->agreement / n) << "%) after checking "
+             << checked.load() << "/" << totalCombinations << " combinations" << endl;
+        return result;
+    }
+    
+    // Bits of confidence one random k-subset adds, assuming `honest` shares
+    // are correct: -log2(1 - q) with q = C(honest, k) / C(n, k) the chance
+    // that the subset avoids every wrong share
+    double bitsPerSample(int honest) const {
+        double q = 1.0;
+        for (int i = 0; i < k; i++) {
+            q *= static_cast<double>(honest - i) / (n - i);
+        }
+        if (q <= 0.0) return 0.0;
+        if (q >= 1.0) return numeric_limits<double>::infinity();
+        return -log2(1.0 - q);
+    }
+    
+    // Random k-subset for sample number `sample`, derived from the seed
+    // alone so a run is reproducible whichever thread draws it
+    vector<int> randomSubset(uint64_t seed, uint64_t sample) const {
+        seed_seq sequence{uint32_t(seed), uint32_t(seed >> 32), uint32_t(sample), uint32_t(sample >> 32)};
+        mt19937_64 rng(sequence);
+        
+        // Partial Fisher-Yates shuffle
+        vector<int> pool(n);
+        iota(pool.begin(), pool.end(), 0);
+        for (int i = 0; i < k; i++) {
+            uniform_int_distribution<int> pick(i, n - 1);
+            swap(pool[i], pool[pick(rng)]);
+        }
+        vector<int> combo(pool.begin(), pool.begin() + k);
+        sort(combo.begin(), combo.end());
+        return combo;
+    }
+    
+    // RANSAC: verify candidates from random k-subsets until an all-honest
+    // subset has been drawn with the requested confidence. The number of
+    // honest shares is estimated by the best candidate's agreement; that
+    // estimate only grows, so the required sample count only shrinks. A
+    // candidate agreeing with n - floor((n-k)/2) shares settles it outright,
+    // since no other polynomial can then match its support.
+    SolveResult solveBySampling() {
+        int decisive = n - max(BerlekampWelchDecoder::errorBound(n, k), 0);
+        PolynomialRing ring{PrimeField(PRIME)};
+        prepareCandidateChecks();
+        
+        uint64_t seed = options.seed ? *options.seed : (uint64_t(random_device{}()) << 32) ^ random_device{}();
+        double targetBits = options.confidenceBits;
+        int threads = resolveThreadCount(options.threads);
+        cout << "🎲 Sampling random combinations until confidence 1 - 2^-" << targetBits
+             << " (seed " << seed << ", at most " << options.maxSamples << " samples";
+        if (threads > 1) cout << ", " << threads << " threads";
+        cout << ")..." << endl;
+        
+        Candidate best;
+        mutex bestMutex;
+        atomic<uint64_t> sampled{0};
+        atomic<bool> confident{false};
+        
+        forEachRankRange(options.maxSamples, threads, [&](uint64_t begin, uint64_t end, int, BigIntArena& arena) {
+            for (uint64_t sample = begin; sample < end; sample++) {
+                if (confident.load(memory_order_relaxed) || !budget->spend()) return;
+                checkAndKeep(randomSubset(seed, sample), sample, ring, arena, best, &bestMutex);
                 
-                BigInt secret = lagrangeInterpolation(points);
-                if (secret.toString() == correctSecret) {
-                    for (int idx : combo) {
-                        validShareIndices.insert(idx);
-                    }
+                uint64_t drawn = ++sampled;
+                lock_guard<mutex> lock(bestMutex);
+                if (best.agreement >= decisive ||
+                    (best.agreement >= k && drawn * bitsPerSample(best.agreement) >= targetBits)) {
+                    confident = true;
                 }
-            } catch (const exception& e) {
-                continue;
             }
+        }, [&] { return confident.load(memory_order_relaxed); });
+        
+        if (best.agreement < 0) {
+            throw runtime_error(budget->exhausted() ? string("Budget exhausted before a candidate was found (") +
+                                describe(budget->reason()) + ")" : string("Could not determine the correct secret"));
         }
         
-        // Identify wrong shares
-        vector<int> wrongShares;
+        SolveResult result;
+        result.examined = sampled.load();
+        result.total = BinomialTable(n).at(n, k);
+        result.confidence = confidenceFor(best.agreement, result.examined);
+        if (confident) {
+            result.stopReason = best.agreement >= decisive ? StopReason::Decided : StopReason::Confident;
+        } else if (budget->exhausted()) {
+            result.stopReason = budget->reason();
+        } else {
+            result.stopReason = StopReason::WorkLimit;
+            cout << "   Sample limit reached before the requested confidence" << endl;
+        }
+        double achievedBits = sampled.load() * bitsPerSample(best.agreement);
+        reportCandidate(best, ring, result);
+        
+        cout << "📈 AGREEING SHARES: " << best.agreement << "/" << n
+             << " (" << (100.0 * best.agreement / n) << "%) after " << sampled.load() << " samples, ";
+        if (best.agreement >= decisive) {
+            cout << "unique (no other polynomial fits as many shares)" << endl;
+        } else {
+            cout << "confidence 1 - 2^-" << achievedBits << endl;
+        }
+        return result;
+    }
+    
+    // Fold a worker's chunk tally into the shared one and decide whether
+    // the search can stop: when the leader is ahead of any rival by more
+    // than the combinations left, or the quorum has been reached.
+    void mergeChunk(TallyProgress& progress, SecretTally& local, uint64_t combinations) {
+        lock_guard<mutex> lock(progress.lock);
+        auto& entries = progress.tally.entries();
+        for (auto& entry : local.entries()) {
+            size_t slot = progress.tally.locate(move(entry.key), entry.hash);
+            SecretVote& vote = entries[slot].value;
+            vote.merge(entry.value);
+            
+            // Counts only grow, so the old leader's count bounds the rest
+            // whenever the lead changes hands
+            if (slot == progress.leader) continue;
+            const SecretVote* leader = progress.leader == SIZE_MAX ? nullptr : &entries[progress.leader].value;
+            if (!leader || vote.count > leader->count ||
+                (vote.count == leader->count && vote.firstRank < leader->firstRank)) {
+                if (leader) progress.runnerUpBound = max(progress.runnerUpBound, leader->count);
+                progress.leader = slot;
+            } else {
+                progress.runnerUpBound = max(progress.runnerUpBound, vote.count);
+            }
+        }
+        local.clear();
+        progress.merged += combinations;
+        
+        if (progress.leader == SIZE_MAX) return;
+        uint64_t remaining = progress.total - progress.merged;
+        uint64_t leaderCount = entries[progress.leader].value.count;
+        if (remaining > 0 && leaderCount > progress.runnerUpBound + remaining) {
+            progress.decided = true;
+            progress.stop = true;
+        }
+        if (remaining > 0 && options.quorum > 0 && leaderCount >= static_cast<uint64_t>(options.quorum)) {
+            progress.quorumReached = true;
+            progress.stop = true;
+        }
+    }
+    
+    // Interpolate every k-subset and take the secret most of them agree on
+    SolveResult solveByEnumeration() {
+        buildDifferenceTable();
+        PrimeField field(PRIME);
+        zeroShares.clear();
         for (int i = 0; i < n; i++) {
-            if (validShareIndices.find(i) == validShareIndices.end()) {
-                wrongShares.push_back(i + 1); // Convert to 1-based indexing for share IDs
+            if (field.reduce(shares[i].first) == BigInt(0)) zeroShares.push_back(i);
+        }
+        
+        // Combinations are enumerated lazily; only their count is known up front
+        uint64_t totalCombinations = binomial(n, k);
+        int threads = resolveThreadCount(options.threads);
+        
+        cout << "🔍 Testing " << totalCombinations << " combinations";
+        if (threads > 1) cout << " on " << threads << " threads";
+        cout << "..." << endl;
+        
+        // Workers tally small chunks and merge them into the shared tally,
+        // so every worker sees when the outcome is settled. Each worker's
+        // first merges come after 1, 2, 4, ... combinations, so a quorum or
+        // an early decision is noticed before every worker has done a full
+        // interval.
+        TallyProgress progress;
+        progress.total = totalCombinations;
+        uint64_t interval = max<uint64_t>(1, min<uint64_t>(TallyMergeInterval, totalCombinations / 32));
+        vector<uint64_t> steps(threads, 1);
+        forEachRankRange(totalCombinations, threads, [&](uint64_t begin, uint64_t end, int worker, BigIntArena& arena) {
+            SecretTally local;
+            uint64_t& step = steps[worker];
+            for (uint64_t chunk = begin; chunk < end && !progress.stop.load(memory_order_relaxed); chunk += step, step = min(interval, 2 * step)) {
+                uint64_t chunkEnd = min(end, chunk + step);
+                uint64_t tallied = tallyRange(chunk, chunkEnd, local, arena);
+                mergeChunk(progress, local, tallied);
+                if (tallied < chunkEnd - chunk) return; // out of budget
+            }
+        }, [&] { return progress.stop.load(memory_order_relaxed); });
+        
+        const SecretTally& secretCounts = progress.tally;
+        uint64_t examined = progress.merged;
+        bool stoppedEarly = examined < totalCombinations;
+        
+        // Find the most common secret; ties go to the one seen first
+        const BigInt* winner = nullptr;
+        SecretVote best;
+        
+        for (const auto& entry : secretCounts.entries()) {
+            if (entry.value.count > best.count ||
+                (entry.value.count == best.count && entry.value.firstRank < best.firstRank)) {
+                best = entry.value;
+                winner = &entry.key;
             }
         }
         
-        cout << endl << "🎯 FINAL RESULTS" << endl;
-        cout << "=================" << endl;
-        cout << "🔑 SECRET: " << correctSecret << endl;
+        if (!winner) {
+            throw runtime_error(budget->exhausted() ? string("Budget exhausted before any combination was checked (") +
+                                describe(budget->reason()) + ")" : string("Could not determine the correct secret"));
+        }
         
-        if (!wrongShares.empty()) {
-            cout << "⚠️  WRONG SHARES DETECTED: ";
-            for (size_t i = 0; i < wrongShares.size(); i++) {
-                cout << "Share " << wrongShares[i];
-                if (i < wrongShares.size() - 1) cout << ", ";
+        SolveResult result;
+        result.secret = *winner;
+        result.support = best.count;
+        result.examined = examined;
+        result.total = totalCombinations;
+        if (progress.decided) {
+            result.stopReason = StopReason::Decided;
+        } else if (progress.quorumReached) {
+            result.stopReason = StopReason::Quorum;
+        } else if (stoppedEarly) {
+            result.stopReason = budget->reason();
+        }
+        
+        string correctSecretStr = result.secret.toString();
+        int maxCount = best.count;
+        
+        // After an early stop the counts depend on how far each thread got,
+        // so they are only lower bounds on the full search
+        cout << "✅ Secret found: " << correctSecretStr << endl;
+        if (stoppedEarly) {
+            cout << "   Appears in at least " << maxCount << " out of " << totalCombinations
+                 << " combinations (" << maxCount << " of the " << examined << " examined)" << endl;
+            cout << "⏹️  Stopped after " << examined << "/" << totalCombinations << " combinations: "
+                 << describe(result.stopReason) << endl;
+        } else {
+            cout << "   Appears in " << maxCount << " out of " << examined << " combinations" << endl;
+        }
+        
+        // A shared top count means the shares settle nothing; the pick
+        // is only the tie-break
+        int tied = 0;
+        for (const auto& entry : secretCounts.entries()) {
+            if (entry.value.count == maxCount) tied++;
+        }
+        if (tied > 1) {
+            cout << "⚠️  NO CONSENSUS: " << tied << " secrets tie with " << maxCount
+                 << " combinations each; reporting the one found first" << endl;
+        }
+        
+        // Identify wrong shares against the polynomial through the witness.
+        // An early stop may have examined none, so one is searched for; only
+        // when none exists does the first combination stand in. Either way
+        // the polynomial must reproduce the secret before it judges a share.
+        prepareCandidateChecks(false);
+        vector<int> wrongShares;
+        {
+            BigIntArena::ResetScope scope(setupArena);
+            PolynomialRing ring{field};
+            vector<int> combo;
+            if (best.hasWitness()) {
+                best.witness.forEach([&](int idx) { combo.push_back(idx); });
+            } else if (stoppedEarly) {
+                combo = findWitness(result.secret, ring);
             }
-            cout << endl;
+            if (combo.empty()) best.representative.forEach([&](int idx) { combo.push_back(idx); });
+            Polynomial polynomial;
+            int agreement = checkCandidate(combo, ring, polynomial);
+            BigInt rebuilt = polynomial.empty() ? BigInt(0) : polynomial[0];
+            if (rebuilt != result.secret) {
+                throw runtime_error("Winning combination does not reproduce the secret " + correctSecretStr);
+            }
+            if (stoppedEarly && !progress.decided) result.confidence = confidenceFor(agreement, examined);
+            if (tied > 1) result.confidence = min(result.confidence, 1.0 / tied);
+            
+            for (int i = 0; i < n; i++) {
+                if (ring.evaluate(polynomial, reducedX[i]) != reducedY[i]) wrongShares.push_back(i);
+            }
+        }
+        
+        result.wrongShares = shareIds(wrongShares);
+        printFinalResults(result);
+        
+        if (stoppedEarly) {
+            cout << "📈 VALID COMBINATIONS: at least " << maxCount << "/" << totalCombinations
+                 << " (" << (100.0 * maxCount / examined) << "% of the " << examined << " examined)" << endl;
         } else {
-            cout << "✅ NO WRONG SHARES DETECTED" << endl;
+            cout << "📈 VALID COMBINATIONS: " << maxCount << "/" << examined
+                 << " (" << (100.0 * maxCount / examined) << "%)" << endl;
         }
+        return result;
+    }
+    
+    // Earliest combination without a share at x = 0 that interpolates to
+    // secret, for an early stop that examined none; empty if there is none
+    vector<int> findWitness(const BigInt& secret, const PolynomialRing& ring) {
+        vector<int> positions;
+        for (int i = 0; i < n; i++) {
+            if (find(zeroShares.begin(), zeroShares.end(), i) == zeroShares.end()) positions.push_back(i);
+        }
+        if (static_cast<int>(positions.size()) < k) return {};
+        
+        vector<int> combo(k);
+        vector<BigInt> subsetX(k), subsetY(k);
+        for (CombinationGenerator generator(static_cast<int>(positions.size()), k); !generator.done(); generator.next()) {
+            for (int i = 0; i < k; i++) {
+                combo[i] = positions[generator.current()[i]];
+                subsetX[i] = reducedX[combo[i]];
+                subsetY[i] = reducedY[combo[i]];
+            }
+            try {
+                Polynomial polynomial = ring.interpolate(subsetX, subsetY);
+                if ((polynomial.empty() ? BigInt(0) : polynomial[0]) == secret) return combo;
+            } catch (const exception&) {
+                // repeated ids; no polynomial through this subset
+            }
+        }
+        return {};
+    }
+    
+    // Recover the secret from a share file. The budget in the options is
+    // checked before every combination or sample; when it runs out the
+    // best candidate so far is returned with result.interrupted() set.
+    SolveResult solve(const string& filename) {
+        budget = make_unique<SolveBudget>(options.deadlineMs, options.maxCombinations, options.cancellation);
+        loadShares(filename);
         
-        cout << "📈 VALID COMBINATIONS: " << maxCount << "/" << combinations.size() 
-             << " (" << (100.0 * maxCount / combinations.size()) << "%)" << endl;
+        if (options.decoder == Decoder::Verify) {
+            return solveByVerification();
+        }
+        if (options.decoder == Decoder::Sample) {
+            return solveBySampling();
+        }
+        SolveResult result;
+        if (options.decoder == Decoder::ReedSolomon && solveReedSolomon(result)) {
+            return result;
+        }
+        return solveByEnumeration();
     }
 };
 
@@ -0,0 +1,139 @@
+#ifndef SHARE_MASK_HPP
+#define SHARE_MASK_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Set of share indices. Indices below 128 live in two inline machine
+// words, so membership, union and size are single word operations and
+// such a subset can be copied and combined without touching the heap.
+// Larger indices spill into further words on the heap.
+class ShareMask {
+private:
+    static constexpr int InlineWords = 2;
+    
+    uint64_t words[InlineWords] = {0, 0};
+    std::vector<uint64_t> spill;    // words from InlineWords on, grown on demand
+    
+    size_t wordCount() const {
+        return InlineWords + spill.size();
+    }
+    
+    uint64_t word(size_t w) const {
+        if (w < InlineWords) return words[w];
+        return w - InlineWords < spill.size() ? spill[w - InlineWords] : 0;
+    }
+    
+    uint64_t& wordRef(size_t w) {
+        if (w < InlineWords) return words[w];
+        if (w - InlineWords >= spill.size()) spill.resize(w - InlineWords + 1, 0);
+        return spill[w - InlineWords];
+    }
+    
+    static int popcount(uint64_t word) {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt64(word));
+#else
+        return __builtin_popcountll(word);
+#endif
+    }
+
+public:
+    // Indices below this never allocate
+    static constexpr int InlineCapacity = 64 * InlineWords;
+    
+    ShareMask() = default;
+    
+    // Mask of a list of non-negative indices
+    static ShareMask of(const std::vector<int>& indices) {
+        ShareMask mask;
+        for (int idx : indices) mask.set(idx);
+        return mask;
+    }
+    
+    void set(int idx) {
+        wordRef(idx >> 6) |= uint64_t(1) << (idx & 63);
+    }
+    
+    void reset(int idx) {
+        if (static_cast<size_t>(idx >> 6) >= wordCount()) return;
+        wordRef(idx >> 6) &= ~(uint64_t(1) << (idx & 63));
+    }
+    
+    bool test(int idx) const {
+        return (word(idx >> 6) >> (idx & 63)) & 1;
+    }
+    
+    int count() const {
+        int total = popcount(words[0]) + popcount(words[1]);
+        for (uint64_t w : spill) total += popcount(w);
+        return total;
+    }
+    
+    bool empty() const {
+        if ((words[0] | words[1]) != 0) return false;
+        for (uint64_t w : spill) {
+            if (w != 0) return false;
+        }
+        return true;
+    }
+    
+    ShareMask& operator|=(const ShareMask& other) {
+        words[0] |= other.words[0];
+        words[1] |= other.words[1];
+        if (spill.size() < other.spill.size()) spill.resize(other.spill.size(), 0);
+        for (size_t i = 0; i < other.spill.size(); i++) {
+            spill[i] |= other.spill[i];
+        }
+        return *this;
+    }
+    
+    ShareMask operator|(const ShareMask& other) const {
+        ShareMask result = *this;
+        return result |= other;
+    }
+    
+    ShareMask operator&(const ShareMask& other) const {
+        ShareMask result;
+        result.words[0] = words[0] & other.words[0];
+        result.words[1] = words[1] & other.words[1];
+        size_t common = std::min(spill.size(), other.spill.size());
+        if (common > 0) {
+            result.spill.resize(common);
+            for (size_t i = 0; i < common; i++) {
+                result.spill[i] = spill[i] & other.spill[i];
+            }
+        }
+        return result;
+    }
+    
+    // Missing spill words count as zero
+    bool operator==(const ShareMask& other) const {
+        size_t total = std::max(wordCount(), other.wordCount());
+        for (size_t w = 0; w < total; w++) {
+            if (word(w) != other.word(w)) return false;
+        }
+        return true;
+    }
+    
+    bool operator!=(const ShareMask& other) const {
+        return !(*this == other);
+    }
+    
+    // Call f(index) for every member in increasing order
+    template<typename F>
+    void forEach(F f) const {
+        for (size_t w = 0; w < wordCount(); w++) {
+            for (uint64_t bits = word(w); bits != 0; bits &= bits - 1) {
+                f(static_cast<int>(w) * 64 + popcount((bits & (~bits + 1)) - 1));
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef SHARE_SPLITTER_HPP
+#define SHARE_SPLITTER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bigint.hpp"
+#include "bigint_arena.hpp"
+#include "prime_field.hpp"
+#include "secure_random.hpp"
+#include "field_polynomial.hpp"
+#include "work_stealing.hpp"
+
+// Creates Shamir shares: f(x) = secret + a_1 x + ... + a_{k-1} x^{k-1}
+// over a prime field with uniformly random a_j, evaluated at x = 1..n.
+// Coefficients come from the OS CSPRNG (secureRandomBytes) by rejection
+// sampling, so every field element is equally likely.
+class ShareSplitter {
+private:
+    PrimeField field;
+    PolynomialRing ring;
+    int threads;
+    std::vector<uint8_t> topMask;   // allowed bits of each byte of a draw
+    
+    // Uniform element of [0, p)
+    BigInt randomElement() {
+        std::vector<uint8_t> bytes(topMask.size());
+        while (true) {
+            secureRandomBytes(bytes.data(), bytes.size());
+            for (size_t i = 0; i < bytes.size(); i++) {
+                bytes[i] &= topMask[i];
+            }
+            BigInt candidate = BigInt::fromBytes(bytes);
+            if (candidate < field.modulus()) return candidate;
+        }
+    }
+    
+    // f at xs[begin, end). Long polynomials go through a subproduct tree;
+    // otherwise Horner's rule runs in lockstep, applying every coefficient
+    // to the whole block before moving on, so the block shares one pass
+    // over the polynomial.
+    void evaluateBlock(const Polynomial& f, const std::vector<BigInt>& xs, size_t begin, size_t end,
+                       std::vector<BigInt>& out, BigIntArena& arena) const {
+        {
+            BigIntArena::ResetScope scope(arena);
+            if (f.size() >= PolynomialRing::FastEvaluationThreshold) {
+                std::vector<BigInt> block(xs.begin() + begin, xs.begin() + end);
+                std::vector<BigInt> values = ring.evaluateMany(f, block);
+                for (size_t j = begin; j < end; j++) {
+                    out[j] = values[j - begin];
+                }
+            } else {
+                std::vector<BigInt> acc(end - begin, BigInt(0));
+                for (size_t i = f.size(); i-- > 0; ) {
+                    for (size_t j = begin; j < end; j++) {
+                        acc[j - begin] = field.reduce(acc[j - begin] * xs[j] + f[i]);
+                    }
+                }
+                for (size_t j = begin; j < end; j++) {
+                    out[j] = acc[j - begin];
+                }
+            }
+        }
+    }
+
+public:
+    // x-values evaluated together by one worker with Horner's rule
+    static constexpr size_t BlockPoints = 64;
+    
+    explicit ShareSplitter(const BigInt& modulus, int threadCount = 1)
+        : field(modulus), ring(field), threads(resolveThreadCount(threadCount)) {
+        if (!(BigInt(2) < modulus)) {
+            throw std::runtime_error("Share modulus must be a prime above 2");
+        }
+        
+        // Draw as many bytes as p - 1 has, masking the top one to its bit length
+        std::vector<uint8_t> maxBytes = (modulus - BigInt(1)).toBytes();
+        topMask.assign(maxBytes.size(), 0xff);
+        uint8_t top = maxBytes[0];
+        uint8_t mask = 0;
+        while (mask < top) mask = static_cast<uint8_t>((mask << 1) | 1);
+        topMask[0] = mask;
+    }
+    
+    // Random polynomial of degree k - 1 with f(0) = secret
+    Polynomial randomPolynomial(const BigInt& secret, int k) {
+        if (k < 1) {
+            throw std::runtime_error("Threshold must be at least 1");
+        }
+        if (secret.isNegative() || !(secret < field.modulus())) {
+            throw std::runtime_error("Secret must lie in [0, " + field.modulus().toString() + ")");
+        }
+        
+        Polynomial f;
+        f.reserve(k);
+        f.push_back(secret);
+        for (int j = 1; j < k; j++) {
+            f.push_back(randomElement());
+        }
+        return f;
+    }
+    
+    // f(x) for every x, split into blocks across the worker threads
+    std::vector<BigInt> evaluate(const Polynomial& f, const std::vector<BigInt>& xs) const {
+        std::vector<BigInt> ys(xs.size());
+        
+        // A tree block spans about deg f points, the most one tree pays off for
+        size_t blockPoints = BlockPoints;
+        if (f.size() >= PolynomialRing::FastEvaluationThreshold) {
+            while (blockPoints < f.size()) blockPoints *= 2;
+        }
+        uint64_t blocks = (xs.size() + blockPoints - 1) / blockPoints;
+        int workers = static_cast<int>(std::min<uint64_t>(threads, std::max<uint64_t>(1, blocks)));
+        
+        std::vector<std::unique_ptr<BigIntArena>> arenas;
+        for (int i = 0; i < workers; i++) {
+            arenas.push_back(std::make_unique<BigIntArena>());
+        }
+        
+        auto body = [&](uint64_t first, uint64_t last, int worker) {
+            for (uint64_t block = first; block < last; block++) {
+                size_t begin = block * blockPoints;
+                size_t end = std::min(xs.size(), begin + blockPoints);
+                evaluateBlock(f, xs, begin, end, ys, *arenas[worker]);
+            }
+        };
+        
+        if (workers <= 1) {
+            body(0, blocks, 0);
+        } else {
+            WorkStealingRanges ranges(blocks, workers, 1);
+            ranges.run(body);
+        }
+        return ys;
+    }
+    
+    // Shares (id, f(id)) for ids 1..n of a fresh random polynomial
+    std::vector<std::pair<long long, BigInt>> split(const BigInt& secret, int k, int n) {
+        if (n < k) {
+            throw std::runtime_error("Need at least k = " + std::to_string(k) + " shares, got n = " + std::to_string(n));
+        }
+        
+        Polynomial f = randomPolynomial(secret, k);
+        std::vector<BigInt> xs;
+        xs.reserve(n);
+        for (int id = 1; id <= n; id++) {
+            xs.push_back(BigInt(static_cast<long long>(id)));
+        }
+        
+        std::vector<BigInt> ys = evaluate(f, xs);
+        std::vector<std::pair<long long, BigInt>> shares;
+        shares.reserve(n);
+        for (int i = 0; i < n; i++) {
+            shares.emplace_back(i + 1, std::move(ys[i]));
+        }
+        return shares;
+    }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SHARED_FIELD_TABLE_HPP
+#define SHARED_FIELD_TABLE_HPP
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include "bigint.hpp"
+#include "bigint_arena.hpp"
+#include "prime_field.hpp"
+
+// Process-wide instance of a table over 0..n modulo a prime, for tables
+// constructed as Table(field, n) and reporting their size as limit(). The
+// last table is kept and rebuilt (at least doubling) only when a larger n
+// or another modulus is asked for. A rebuild runs in a scratch arena and
+// only the finished table is copied to the heap. Thread-safe; tables are
+// read-only. n must be below the modulus.
+template<typename Table>
+std::shared_ptr<const Table> sharedFieldTable(const PrimeField& field, size_t n) {
+    // The table and its key outlive any arena the caller is using
+    BigIntHeapScope heap;
+    static std::mutex mutex;
+    static std::shared_ptr<const Table> table;
+    static BigInt modulus;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    bool sameField = table && modulus == field.modulus();
+    if (sameField && table->limit() >= n) return table;
+    
+    size_t size = sameField ? std::max(n, 2 * table->limit()) : std::max<size_t>(n, 64);
+    if (!(BigInt(static_cast<long long>(size)) < field.modulus())) size = n;
+    BigIntArena scratch;
+    {
+        BigIntArena::ResetScope scope(scratch);
+        Table built(field, size);
+        BigIntHeapScope copy;
+        table = std::make_shared<const Table>(built);
+    }
+    modulus = field.modulus();
+    return table;
+}
+
+#endif
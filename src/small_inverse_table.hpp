@@ -0,0 +1,54 @@
+#ifndef SMALL_INVERSE_TABLE_HPP
+#define SMALL_INVERSE_TABLE_HPP
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bigint.hpp"
+#include "prime_field.hpp"
+#include "shared_field_table.hpp"
+
+// Field inverses of 1..n without a single exponentiation, from
+//     p = (p / i) * i + (p mod i)   =>   1 / i = -(p / i) * (1 / (p mod i))
+// where p mod i < i is already in the table. Share ids and their
+// differences are small, so Lagrange denominators can be inverted as
+// products of entries instead of with Fermat's little theorem.
+class SmallInverseTable {
+private:
+    std::vector<BigInt> inverses;   // inverses[i] = 1 / i, inverses[0] unused
+
+public:
+    // n must be below p
+    SmallInverseTable(const PrimeField& field, size_t n) : inverses(n + 1) {
+        const BigInt& p = field.modulus();
+        if (!(BigInt(static_cast<long long>(n)) < p)) {
+            throw std::runtime_error("Cannot invert 1.." + std::to_string(n) + " modulo " + p.toString());
+        }
+        
+        inverses[0] = BigInt(0);
+        if (n >= 1) inverses[1] = BigInt(1);
+        for (size_t i = 2; i <= n; i++) {
+            BigInt divisor(static_cast<long long>(i));
+            size_t rest = static_cast<size_t>((p % divisor).toLongLong());
+            inverses[i] = field.sub(BigInt(0), field.mul(p / divisor, inverses[rest]));
+        }
+    }
+    
+    // Largest value covered
+    size_t limit() const {
+        return inverses.size() - 1;
+    }
+    
+    // 1 / i for 1 <= i <= limit()
+    const BigInt& inverse(size_t i) const {
+        return inverses[i];
+    }
+    
+    // Process-wide table for the modulus covering at least 1..n
+    static std::shared_ptr<const SmallInverseTable> shared(const PrimeField& field, size_t n) {
+        return sharedFieldTable<SmallInverseTable>(field, n);
+    }
+};
+
+#endif
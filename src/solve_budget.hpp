@@ -0,0 +1,107 @@
+#ifndef SOLVE_BUDGET_HPP
+#define SOLVE_BUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Flag a caller can raise from any thread (or a signal handler) to stop a
+// running solve. Copies share the same flag.
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+
+public:
+    void cancel() const {
+        flag->store(true);
+    }
+    
+    bool cancelled() const {
+        return flag->load(std::memory_order_relaxed);
+    }
+};
+
+// Why a search ended
+enum class StopReason {
+    Completed,      // the whole search space was covered
+    Decided,        // no other secret could catch up
+    Quorum,         // a secret reached the requested vote count
+    Confident,      // sampling reached the requested confidence
+    Deadline,       // out of time
+    WorkLimit,      // out of combinations
+    Cancelled       // stopped through a CancellationToken
+};
+
+inline const char* describe(StopReason reason) {
+    switch (reason) {
+        case StopReason::Completed: return "search completed";
+        case StopReason::Decided: return "no other secret can catch up";
+        case StopReason::Quorum: return "quorum reached";
+        case StopReason::Confident: return "confidence reached";
+        case StopReason::Deadline: return "deadline expired";
+        case StopReason::WorkLimit: return "combination budget spent";
+        case StopReason::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+// Time and work allowance for one solve. Workers call spend() before each
+// combination or sample; once any limit is hit every later call fails and
+// the first reason is kept. The very first unit is always granted, so even
+// an expired budget leaves one candidate to report. The clock is read only
+// every ClockInterval calls on each thread, so a deadline may be overrun by
+// that many units per worker.
+class SolveBudget {
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    Clock::time_point deadline;
+    bool hasDeadline;
+    uint64_t maxWork;
+    CancellationToken token;
+    std::atomic<uint64_t> spent{0};
+    std::atomic<bool> started{false};
+    std::atomic<bool> over{false};
+    std::atomic<int> firstReason{static_cast<int>(StopReason::Completed)};
+    
+    bool stop(StopReason reason) {
+        int expected = static_cast<int>(StopReason::Completed);
+        firstReason.compare_exchange_strong(expected, static_cast<int>(reason));
+        over = true;
+        return false;
+    }
+
+public:
+    // deadlineMs and maxWork of 0 mean unlimited
+    SolveBudget(long long deadlineMs, uint64_t maxWork, const CancellationToken& cancellation)
+        : deadline(Clock::now() + std::chrono::milliseconds(deadlineMs)), hasDeadline(deadlineMs > 0),
+          maxWork(maxWork), token(cancellation) {}
+    
+    static constexpr unsigned ClockInterval = 16;
+    
+    // Claim one unit of work; false once the budget is exhausted
+    bool spend() {
+        // Only the first call writes the flag; later ones just read it
+        if (!started.load(std::memory_order_relaxed) && !started.exchange(true)) {
+            if (maxWork > 0) spent++;
+            return true;
+        }
+        if (over.load(std::memory_order_relaxed)) return false;
+        if (token.cancelled()) return stop(StopReason::Cancelled);
+        static thread_local unsigned calls = 0;
+        if (hasDeadline && ++calls % ClockInterval == 0 && Clock::now() >= deadline) return stop(StopReason::Deadline);
+        if (maxWork > 0 && spent.fetch_add(1, std::memory_order_relaxed) >= maxWork) return stop(StopReason::WorkLimit);
+        return true;
+    }
+    
+    bool exhausted() const {
+        return over.load();
+    }
+    
+    StopReason reason() const {
+        return static_cast<StopReason>(firstReason.load());
+    }
+};
+
+#endif
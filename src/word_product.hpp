@@ -0,0 +1,63 @@
+#ifndef WORD_PRODUCT_HPP
+#define WORD_PRODUCT_HPP
+
+#include <cstdint>
+#include "bigint.hpp"
+
+// Running product of machine integers such as share ids or their
+// differences. Factors are multiplied into a native word (128 bits where
+// the compiler has them, 64 otherwise) and folded into the BigInt only
+// when the next factor would overflow it, so a product of k small ids
+// costs about k word multiplications and a handful of BigInt ones. With a
+// non-zero modulus the BigInt is reduced after every fold; a zero modulus
+// keeps the exact integer.
+class WordProduct {
+private:
+#ifdef __SIZEOF_INT128__
+    using Word = unsigned __int128;
+#else
+    using Word = uint64_t;
+#endif
+
+    const BigInt& modulus;
+    BigInt value;
+    Word word = 1;
+    bool negative = false;
+    
+    static BigInt toBigInt(Word w) {
+        uint8_t bytes[sizeof(Word)];
+        for (size_t i = 0; i < sizeof(Word); i++) {
+            bytes[i] = static_cast<uint8_t>(w >> (8 * i));
+        }
+        return BigInt::fromBytes(bytes, sizeof(Word), ByteOrder::LittleEndian);
+    }
+    
+    void fold() {
+        value = value * toBigInt(word);
+        if (modulus != BigInt(0)) value = value % modulus;
+        word = 1;
+    }
+
+public:
+    // modulus must outlive the product
+    explicit WordProduct(const BigInt& mod) : modulus(mod), value(1) {}
+    
+    void multiply(long long factor) {
+        if (factor < 0) negative = !negative;
+        uint64_t magnitude = factor < 0 ? 0 - static_cast<uint64_t>(factor) : static_cast<uint64_t>(factor);
+        if (magnitude != 0 && word > ~Word(0) / magnitude) fold();
+        word *= magnitude;
+    }
+    
+    // The product so far; reduced into [0, modulus) when a modulus is set
+    BigInt result() {
+        fold();
+        if (modulus == BigInt(0)) {
+            return negative ? BigInt(0) - value : value;
+        }
+        if (negative && value != BigInt(0)) return modulus - value;
+        return value;
+    }
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Resolve a requested thread count; 0 means one per hardware thread
+inline int resolveThreadCount(int requested) {
+    if (requested > 0) return requested;
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : static_cast<int>(hardware);
+}
+
+// Runs body(begin, end, worker) over [0, total) on `threads` workers.
+//
+// Every worker starts with an equal contiguous block and consumes it from
+// the front in grain-sized chunks. A worker whose block runs dry steals the
+// back half of the largest remaining block, so uneven chunk costs still
+// keep every thread busy. Chunks handed to one worker are disjoint and
+// together cover the range exactly once.
+//
+// Once stop() is called, or the optional predicate passed to run() holds
+// after a chunk, no further chunks are handed out; chunks already running
+// finish. The first exception thrown by body stops all workers and is
+// rethrown.
+class WorkStealingRanges {
+private:
+    struct Block {
+        std::mutex mutex;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    uint64_t grain;
+    std::atomic<bool> stopped{false};
+
+    bool takeChunk(int worker, uint64_t& begin, uint64_t& end) {
+        if (stopped.load(std::memory_order_relaxed)) return false;
+        Block& own = *blocks[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin >= own.end) return false;
+        begin = own.begin;
+        end = std::min(own.end, own.begin + grain);
+        own.begin = end;
+        return true;
+    }
+
+    bool steal(int worker) {
+        while (!stopped.load(std::memory_order_relaxed)) {
+            // Pick the victim with the most work left
+            int victim = -1;
+            uint64_t largest = 0;
+            for (size_t i = 0; i < blocks.size(); i++) {
+                if (static_cast<int>(i) == worker) continue;
+                std::lock_guard<std::mutex> lock(blocks[i]->mutex);
+                uint64_t remaining = blocks[i]->end - blocks[i]->begin;
+                if (remaining > largest) {
+                    largest = remaining;
+                    victim = static_cast<int>(i);
+                }
+            }
+            if (victim < 0) return false;
+
+            std::scoped_lock lock(blocks[victim]->mutex, blocks[worker]->mutex);
+            Block& from = *blocks[victim];
+            uint64_t remaining = from.end - from.begin;
+            if (remaining == 0) continue; // drained meanwhile, look again
+
+            uint64_t half = remaining <= grain ? remaining : remaining / 2;
+            blocks[worker]->begin = from.end - half;
+            blocks[worker]->end = from.end;
+            from.end -= half;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    WorkStealingRanges(uint64_t total, int threads, uint64_t grainSize) : grain(std::max<uint64_t>(1, grainSize)) {
+        for (int i = 0; i < threads; i++) {
+            blocks.push_back(std::make_unique<Block>());
+            blocks[i]->begin = total / threads * i + std::min<uint64_t>(i, total % threads);
+            blocks[i]->end = blocks[i]->begin + total / threads + (static_cast<uint64_t>(i) < total % threads ? 1 : 0);
+        }
+    }
+
+    // Hand out no more chunks; safe to call from any thread
+    void stop() {
+        stopped = true;
+    }
+
+    void run(const std::function<void(uint64_t, uint64_t, int)>& body,
+             const std::function<bool()>& stopWhen = nullptr) {
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto worker = [&](int id) {
+            try {
+                uint64_t begin, end;
+                while (true) {
+                    if (takeChunk(id, begin, end)) {
+                        body(begin, end, id);
+                        if (stopWhen && stopWhen()) stop();
+                    } else if (!steal(id)) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                stop();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < blocks.size(); i++) {
+            pool.emplace_back(worker, static_cast<int>(i));
+        }
+        worker(0);
+        for (auto& thread : pool) thread.join();
+
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+#endif